@@ -0,0 +1,86 @@
+/*
+    Arena allocator of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "arena.h"
+#include "define.h"
+
+#include <cstdlib>
+
+#include <new>
+
+namespace scc
+{
+    // class Arena
+
+    Arena::Arena() : chunk(0), cur(nullptr), end(nullptr)
+    {
+    }
+
+    Arena::~Arena()
+    {
+        for (char* it : chunks)
+        {
+            free(it);
+        }
+    }
+
+    void* Arena::grow(size_t size, size_t align)
+    {
+        // chunks are aligned for any type by malloc
+        size_t need = size + align;
+        if (cur != nullptr)
+        {
+            chunk++;
+        }
+        while (chunk < chunks.size() && chunkSizes[chunk] < need)
+        {
+            chunk++;
+        }
+        if (chunk >= chunks.size())
+        {
+            size_t n = need > CHUNK_SIZE ? need : CHUNK_SIZE;
+            char* p = static_cast<char*>(malloc(n));
+            if (p == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+            chunk = chunks.size();
+            chunks.push_back(p);
+            chunkSizes.push_back(n);
+        }
+        cur = chunks[chunk];
+        end = cur + chunkSizes[chunk];
+        return allocate(size, align);
+    }
+
+    void Arena::reset()
+    {
+        chunk = 0;
+        if (chunks.empty())
+        {
+            cur = end = nullptr;
+        }
+        else
+        {
+            cur = chunks[0];
+            end = cur + chunkSizes[0];
+        }
+    }
+}
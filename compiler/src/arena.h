@@ -0,0 +1,111 @@
+/*
+    Arena allocator of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _SCC_ARENA_H_
+#define _SCC_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace scc
+{
+    /**
+     * Bump allocator over chunks, freed all at once by reset, which keeps the chunks for reuse.
+     * Only trivially destructible objects may be made in it, as nothing is destroyed
+     */
+    class Arena
+    {
+    protected:
+
+        static const size_t CHUNK_SIZE = 1 << 16;
+
+        std::vector<char*> chunks;
+
+        std::vector<size_t> chunkSizes;
+
+        // index of the chunk in use
+        size_t chunk;
+
+        char* cur;
+
+        char* end;
+
+        /**
+         * Move to the next chunk large enough, allocating it if none
+         */
+        void* grow(size_t size, size_t align);
+
+    public:
+
+        Arena();
+
+        Arena(const Arena&) = delete;
+
+        ~Arena();
+
+        Arena& operator=(const Arena&) = delete;
+
+        void* allocate(size_t size, size_t align)
+        {
+            size_t pad = -reinterpret_cast<uintptr_t>(cur) & (align - 1);
+            if (cur == nullptr || pad + size > static_cast<size_t>(end - cur))
+            {
+                return grow(size, align);
+            }
+            char* p = cur + pad;
+            cur = p + size;
+            return p;
+        }
+
+        template<typename T, typename... Args>
+        T* make(Args&&... args)
+        {
+            static_assert(std::is_trivially_destructible<T>::value, "never destroyed in arena");
+            return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        /**
+         * @return n zeroed objects
+         */
+        template<typename T>
+        T* makeArray(size_t n)
+        {
+            static_assert(std::is_trivial<T>::value, "zeroed in arena");
+            void* p = allocate(sizeof(T) * n, alignof(T));
+            memset(p, 0, sizeof(T) * n);
+            return static_cast<T*>(p);
+        }
+
+        /**
+         * Free all objects, keeping the chunks
+         */
+        void reset();
+    };
+}
+
+#endif // _SCC_ARENA_H_
@@ -19,21 +19,17 @@
 */
 
 #include "config.h"
+#include "objcache.h"
 #include "define.h"
 
 #include "../../common/src/exception.h"
 
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 
-FILE* popen(const void*, const void*)
-{
-    return nullptr;
-}
-
-void pclose(const void*)
-{
-}
+#include <string>
+#include <vector>
 
 // class Config
 
@@ -53,11 +49,24 @@ const char *const Config::HELP =
     "  -o <file> --object <file>   Place pcode into <file>.\n"
     "  -b        --bin             Generate binary pcode. (default)\n"
     "  -t        --text            Generate textual pcode instead of binary one.\n"
+    "  -v        --verbose         Display statistics of optimization.\n"
+    "  -T        --threaded-lex    Lex in another thread while parsing.\n"
+    "  -M <file> --manifest <file> Also compile input files listed in <file>, one per line.\n"
+    "  -j <n>    --jobs <n>        Compile many input files with <n> threads. (default: count of cores)\n"
+    "            --server <sock>   Serve compile requests on Unix socket <sock> until interrupted.\n"
+    "            --connect <sock>  Compile in the server on <sock>, or here if it is not running.\n"
+    "            --cache           Take unchanged objects from the object cache, or save them into it.\n"
+    "            --cache-size <n>  Limit the object cache to <n> MiB. (default: 256)\n"
+    "            --cache-stats     Display the size and hits of the object cache.\n"
+    "            --time-report     Display the time of each phase, counts and peak memory in stderr.\n"
+    "            --time-report-json <file>\n"
+    "                              Place the time report in JSON into <file>.\n"
     "  -h        --help            Display this infomation.\n"
-    "  -v        --version         Display compiler version information.\n"
+    "            --version         Display compiler version information.\n"
     "\n"
     "   Set <file> to '-' to read from stdin / write to stdout.\n"
     "   Set parser file to '@' to write to the same file as lexer.\n"
+    "   With many input files, '%' in output file names stands for each input file without extension.\n"
     "\n"
     "Examples:\n"
     "\n"
@@ -69,44 +78,38 @@ const char *const Config::HELP =
     "\n"
     "  scc testfile.txt -e output.txt -p @\n"
     "  Place lexical analysis result and parsing result into output.txt.\n"
+    "\n"
+    "  scc a.txt b.txt -M list.txt -j 4 -e %.lex\n"
+    "  Compile a.txt, b.txt and files listed in list.txt with 4 threads, placing pcode into a.bpc...\n"
+    "  and lexical analysis results into a.lex...\n"
     "\n";
 
-char* Config::splitPath(char* path)
-{
-    char* p = strrchr(path, '/');
-    if (p != nullptr)
-    {
-        return p;
-    }
-    else
-    {
-        return strrchr(path, '\\');
-    }
-}
-
-const char* Config::splitPath(const char* path)
-{
-    const char* p = strrchr(path, '/');
-    if (p != nullptr)
-    {
-        return p;
-    }
-    else
-    {
-        return strrchr(path, '\\');
-    }
-}
-
 Config::Config() :
 
         langFileName("sc.lang"),
 
+        customLang(false),
+
 #ifdef CG
         inputFileName("testfile.txt"),
 #else
         inputFileName(nullptr),
 #endif
 
+        manifestFileName(nullptr),
+
+        jobs(0),
+
+        serverName(nullptr),
+
+        connectName(nullptr),
+
+        cache(false),
+
+        cacheSize(scc::ObjectCache::DEFAULT_LIMIT),
+
+        cacheStats(false),
+
 #if defined(CG) && CG == 1
         lexOnly(true),
 #else
@@ -141,72 +144,85 @@ Config::Config() :
         mipsFileName(nullptr),
 #endif
 
-        optimize(true)
+        optimize(true),
+
+        verbose(false),
+
+        threadedLex(false),
+
+        timeReport(false),
+
+        timeReportFileName(nullptr)
 {
 }
 
-void Config::set(int argc, char **argv)
+std::string Config::expand(const char* name, const char* inputFileName)
 {
-    cmdName = argv[0];
-
-    RuntimeError::setCmdName(cmdName);
-
-    char* buffer = new char[FILENAME_MAX];
-    buffer[0] = '\0';
-    int PREFIX_MAX = FILENAME_MAX - strlen(langFileName);
+    const char* ext = strrchr(inputFileName, '.');
+    std::string stem(inputFileName, ext != nullptr ? ext - inputFileName : strlen(inputFileName));
+    std::string res;
+    for (const char* p = name; *p != '\0'; p++)
+    {
+        if (*p == '%')
+        {
+            res += stem;
+        }
+        else
+        {
+            res += *p;
+        }
+    }
+    return res;
+}
 
-    char* p = splitPath(argv[0]);
-    if (p != nullptr)
+void Config::readManifest()
+{
+    FILE* fp = strcmp(manifestFileName, "-") == 0 ? stdin : fopen(manifestFileName, "r");
+    if (fp == nullptr)
     {
-        strcpy(buffer, cmdName);
-        p += buffer - cmdName;
+        throw FileError(manifestFileName, "manifest");
     }
-    else
+    const int BUFFER_MAX = FILENAME_MAX + 2;
+    char line[BUFFER_MAX];
+    while (fgets(line, BUFFER_MAX, fp) != nullptr)
     {
-        FILE *fp = popen("where scc", "r");
-        if (fp != nullptr)
+        // one file per line, where empty lines and lines starting with '#' are skipped
+        int n = strlen(line);
+        while (n > 0 && (line[n - 1] == '\n' || line[n - 1] == '\r' || line[n - 1] == ' '))
         {
-            fgets(buffer, PREFIX_MAX, fp);
-            pclose(fp);
+            line[--n] = '\0';
         }
-        p = splitPath(buffer);
-        if (p == nullptr)
+        if (n > 0 && line[0] != '#')
         {
-            fp = popen("which scc", "r");
-            if (fp != nullptr)
-            {
-                fgets(buffer, PREFIX_MAX, fp);
-                pclose(fp);
-            }
-            p = splitPath(buffer);
+            char* fileName = new char[n + 1];
+            strcpy(fileName, line);
+            inputFileNames.push_back(fileName);
         }
     }
-    if (p != nullptr)
+    if (fp != stdin)
     {
-        strcpy(p + 1, langFileName);
-        langFileName = buffer;
+        fclose(fp);
     }
+}
+
+void Config::set(int argc, char **argv)
+{
+    cmdName = argv[0];
+
+    RuntimeError::setCmdName(cmdName);
 
 #ifndef CG
 
-    bool hasInputFile = false;
+    const char* jobsArg = nullptr;
+    const char* cacheSizeArg = nullptr;
     for (int i = 1; i < argc; i++)
     {
         const char** fileName = nullptr;
         // TODO: help
         if (argv[i][0] != '-' || argv[i][1] == '\0')
         {
-            // TODO
-            if (!hasInputFile)
-            {
-                fileName = &inputFileName;
-                hasInputFile = true;
-                i--;
-            }
-            else
-            {
-                throw InvalidArgumentError("except option before", argv[i]); // TODO
-            }
+            inputFileNames.push_back(argv[i]);
+            continue;
         }
         else if (argv[i][1] != '-')
         {
@@ -226,6 +242,7 @@ void Config::set(int argc, char **argv)
                     break;
 
                 case 'G':
+                    customLang = true;
                     fileName = &langFileName;
                     more = true;
                     break;
@@ -265,8 +282,21 @@ void Config::set(int argc, char **argv)
                     break;
 
                 case 'v':
-                    printf("scc version %s\n", VERSION);
-                    exit(0);
+                    verbose = true;
+                    break;
+
+                case 'T':
+                    threadedLex = true;
+                    break;
+
+                case 'M':
+                    fileName = &manifestFileName;
+                    more = true;
+                    break;
+
+                case 'j':
+                    fileName = &jobsArg;
+                    more = true;
                     break;
 
                 default:
@@ -300,6 +330,7 @@ void Config::set(int argc, char **argv)
             }
             else if (strcmp(argv[i] + 2, "lang") == 0)
             {
+                customLang = true;
                 fileName = &langFileName;
             }
             else if (strcmp(argv[i] + 2, "lex-only") == 0)
@@ -327,6 +358,50 @@ void Config::set(int argc, char **argv)
             {
                 bin = false;
             }
+            else if (strcmp(argv[i] + 2, "verbose") == 0)
+            {
+                verbose = true;
+            }
+            else if (strcmp(argv[i] + 2, "threaded-lex") == 0)
+            {
+                threadedLex = true;
+            }
+            else if (strcmp(argv[i] + 2, "manifest") == 0)
+            {
+                fileName = &manifestFileName;
+            }
+            else if (strcmp(argv[i] + 2, "jobs") == 0)
+            {
+                fileName = &jobsArg;
+            }
+            else if (strcmp(argv[i] + 2, "server") == 0)
+            {
+                fileName = &serverName;
+            }
+            else if (strcmp(argv[i] + 2, "connect") == 0)
+            {
+                fileName = &connectName;
+            }
+            else if (strcmp(argv[i] + 2, "cache") == 0)
+            {
+                cache = true;
+            }
+            else if (strcmp(argv[i] + 2, "cache-size") == 0)
+            {
+                fileName = &cacheSizeArg;
+            }
+            else if (strcmp(argv[i] + 2, "cache-stats") == 0)
+            {
+                cacheStats = true;
+            }
+            else if (strcmp(argv[i] + 2, "time-report") == 0)
+            {
+                timeReport = true;
+            }
+            else if (strcmp(argv[i] + 2, "time-report-json") == 0)
+            {
+                fileName = &timeReportFileName;
+            }
             else if (strcmp(argv[i] + 2, "help") == 0)
             {
                 printf("%s", HELP);
@@ -368,10 +443,60 @@ void Config::set(int argc, char **argv)
         // TODO
     }
 
-    if (inputFileName == nullptr)
+    if (manifestFileName != nullptr)
+    {
+        readManifest();
+    }
+    if (cacheSizeArg != nullptr)
+    {
+        char* end;
+        long long n = strtoll(cacheSizeArg, &end, 10);
+        if (*end != '\0' || n <= 0 || n > (1ll << 40))
+        {
+            throw InvalidArgumentError("invalid size of cache", cacheSizeArg);
+        }
+        cacheSize = static_cast<uint64_t>(n) << 20;
+    }
+    if (serverName != nullptr || cacheStats)
+    {
+        // input files come with requests, or are not needed
+        return;
+    }
+    if (inputFileNames.empty())
     {
         throw InvalidArgumentError("no input file", nullptr, HELP);
     }
+    inputFileName = inputFileNames[0];
+    if (inputFileNames.size() == 1)
+    {
+        inputFileNames.clear();
+    }
+
+    if (jobsArg != nullptr)
+    {
+        char* end;
+        jobs = strtol(jobsArg, &end, 10);
+        if (*end != '\0' || jobs <= 0)
+        {
+            throw InvalidArgumentError("invalid count of jobs", jobsArg);
+        }
+    }
+
+    if (!inputFileNames.empty())
+    {
+        if (objectFileName == nullptr)
+        {
+            objectFileName = bin ? "%.bpc" : "%.tpc";
+        }
+        const char* const outputs[] = {lexFileName, parserFileName, objectFileName};
+        for (const char* it : outputs)
+        {
+            if (it != nullptr && strcmp(it, "@") != 0 && strchr(it, '%') == nullptr)
+            {
+                throw InvalidArgumentError("missing '%' for many input files in", it);
+            }
+        }
+    }
 
 #endif
 
@@ -381,9 +506,9 @@ void Config::set(int argc, char **argv)
     {
         const char* ext = bin ? ".bpc" : ".tpc";
         int n = strlen(inputFileName);
-        buffer = new char[n + 5];
+        char* buffer = new char[n + 5];
         strcpy(buffer, inputFileName);
-        p = strrchr(buffer, '.');
+        char* p = strrchr(buffer, '.');
         if (p != nullptr)
         {
             strcpy(p, ext);
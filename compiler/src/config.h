@@ -23,6 +23,11 @@
 #ifndef _SCC_CONFIG_H_
 #define _SCC_CONFIG_H_
 
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
 /**
  * Config manager
  */
@@ -32,9 +37,12 @@ private:
 
     static const char* const HELP;
 
-    static char* splitPath(char* path);
-
-    static const char* splitPath(const char* path);
+    /**
+     * Append the input files listed in manifestFileName
+     *
+     * @exception throw FileError if fail
+     */
+    void readManifest();
 
 public:
 
@@ -44,8 +52,45 @@ public:
 
     const char *langFileName;
 
+    /**
+     * Whether a lang file is given, otherwise the tables generated from sc.lang are used
+     */
+    bool customLang;
+
     const char *inputFileName;
 
+    /**
+     * All input files if more than one are given, in which case '%' in the names of output files
+     * stands for the name of each input file without extension
+     */
+    std::vector<const char*> inputFileNames;
+
+    const char *manifestFileName;
+
+    /**
+     * Count of threads to compile many input files, 0 for the count of cores
+     */
+    int jobs;
+
+    /**
+     * Unix socket to serve compile requests on, or to send the arguments to, if not null
+     */
+    const char *serverName;
+
+    const char *connectName;
+
+    /**
+     * Whether to take objects from and save them to the object cache
+     */
+    bool cache;
+
+    /**
+     * Limit of the size of the object cache in bytes
+     */
+    uint64_t cacheSize;
+
+    bool cacheStats;
+
     bool lexOnly;
 
     const char *lexFileName;
@@ -62,8 +107,27 @@ public:
 
     bool optimize;
 
+    bool verbose;
+
+    /**
+     * Whether to lex in another thread while parsing
+     */
+    bool threadedLex;
+
+    /**
+     * Whether to print the time of each phase into stderr, and where to place it in JSON if not null
+     */
+    bool timeReport;
+
+    const char *timeReportFileName;
+
     Config();
 
+    /**
+     * @return name with each '%' replaced with the name of input file without extension
+     */
+    static std::string expand(const char* name, const char* inputFileName);
+
     /**
      * Set options according to arguments
      * 
@@ -71,6 +135,7 @@ public:
      * @param argv: values of arguments
      * 
      * @exception throw InvalidArgumentError if fail
+     * @exception throw FileError if the manifest is not found
      */
     void set(int argc, char **argv);
 };
@@ -0,0 +1,215 @@
+/*
+    Finite automata of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _SCC_DFA_H_
+#define _SCC_DFA_H_
+
+#include <cstdio>
+
+#include <string>
+#include <vector>
+
+namespace scc
+{
+    /**
+     * NFA with epsilon edges, in which state 0 is the start state.
+     * States are numbered in order of creation, and when several accepting states
+     * are reached at once, the data of the first one wins
+     */
+    template<class T, char _KEY_L = static_cast<char>(32), char _KEY_R = static_cast<char>(126)>
+    class NFA
+    {
+    public:
+
+        struct Edge
+        {
+            char first;
+            char last;
+            int to;
+
+            Edge(char first, char last, int to);
+        };
+
+        struct State
+        {
+            std::vector<Edge> edges;
+            std::vector<int> eps;
+            T data;
+
+            State();
+        };
+
+        static const char KEY_L = _KEY_L;
+        static const char KEY_R = _KEY_R;
+        const T DEFAULT_VAL;
+
+        std::vector<State> states;
+
+        NFA();
+
+        virtual ~NFA();
+
+        /**
+         * @return the new state
+         */
+        int add();
+
+        /**
+         * Add an edge from 'from' to 'to' on [first, last]
+         */
+        void link(int from, char first, char last, int to);
+
+        /**
+         * Add an epsilon edge from 'from' to 'to'
+         */
+        void link(int from, int to);
+
+        void clear();
+    };
+
+    /**
+     * Minimized DFA over equivalence classes of [KEY_L, KEY_R], stored as a dense table.
+     * State DEAD has no way out, state START is the start state, and a move to ABORT
+     * means a character above KEY_R
+     */
+    template<class T, char _KEY_L = static_cast<char>(32), char _KEY_R = static_cast<char>(126)>
+    class DFA
+    {
+    protected:
+
+        /**
+         * Split [KEY_L, KEY_R] into classes of characters on the same edges of nfa
+         */
+        void divide(const NFA<T, _KEY_L, _KEY_R>& nfa);
+
+        /**
+         * Subset construction, in which state 0 is dead and state 1 is the start
+         *
+         * @param trans: trans[s][c] is the move from s on class c
+         * @param accept: data of each state
+         */
+        void subset(const NFA<T, _KEY_L, _KEY_R>& nfa, std::vector<std::vector<int> >& trans,
+                std::vector<T>& accept) const;
+
+        /**
+         * Hopcroft minimization, states of different data are never merged
+         *
+         * @param block: block[s] is the block of state s
+         * @return count of blocks
+         */
+        int minimize(const std::vector<std::vector<int> >& trans, const std::vector<T>& accept,
+                std::vector<int>& block) const;
+
+        /**
+         * Merge classes of the same column in the table
+         */
+        void compress();
+
+        /**
+         * Point the tables to the buffers
+         */
+        void bind();
+
+        /**
+         * Depth-first part of words()
+         */
+        bool words(int state, std::string& word, const char* tail, const T& except,
+                const std::vector<bool>& useful, std::vector<std::string>& keys, std::vector<T>& vals) const;
+
+        std::vector<unsigned char> classBuffer;
+
+        std::vector<int> nextBuffer;
+
+        std::vector<T> dataBuffer;
+
+        int stateCnt;
+
+    public:
+
+        static const char KEY_L = _KEY_L;
+        static const char KEY_R = _KEY_R;
+        static const int DEAD = 0;
+        static const int START = 1;
+        static const int ABORT = -1;
+        const T DEFAULT_VAL;
+
+        int classCnt;
+
+        /**
+         * Class of each byte, class 0 never moves and class 1 always aborts
+         */
+        const unsigned char* classOf;
+
+        /**
+         * next[s * classCnt + c] is the move from s on class c
+         */
+        const int* next;
+
+        const T* data;
+
+        DFA();
+
+        DFA(const DFA&) = delete;
+
+        virtual ~DFA();
+
+        DFA& operator=(const DFA&) = delete;
+
+        void build(const NFA<T, _KEY_L, _KEY_R>& nfa);
+
+        /**
+         * Use tables built elsewhere, which must outlive the DFA
+         *
+         * @param classOf: class of each of the 256 bytes
+         * @param next: stateCnt * classCnt moves
+         * @param data: data of each state
+         */
+        void assign(const unsigned char* classOf, int classCnt, const int* next, const T* data, int stateCnt);
+
+        int move(int state, char c) const
+        {
+            return next[state * classCnt + classOf[static_cast<unsigned char>(c)]];
+        }
+
+        /**
+         * @return the data of the state reached by the whole key, or DEFAULT_VAL
+         */
+        const T& cfind(const char* key, int len) const;
+
+        /**
+         * Collect the words made of a char in head and chars in tail, whose data is neither
+         * DEFAULT_VAL nor except, such as the keywords among identifiers
+         *
+         * @return false if there are infinitely many
+         */
+        bool words(const char* head, const char* tail, const T& except, std::vector<std::string>& keys,
+                std::vector<T>& vals) const;
+
+        int size() const;
+
+        void clear();
+
+        void print(FILE* fp) const;
+    };
+}
+
+#endif // _SCC_DFA_H_
@@ -0,0 +1,609 @@
+/*
+    Implementation of finite automata.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#ifndef _SCC_DFA_TCC_
+#define _SCC_DFA_TCC_
+
+#include "dfa.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace scc
+{
+    // class NFA
+
+    template<class T, char KEY_L, char KEY_R>
+    const char NFA<T, KEY_L, KEY_R>::KEY_L;
+
+    template<class T, char KEY_L, char KEY_R>
+    const char NFA<T, KEY_L, KEY_R>::KEY_R;
+
+    template<class T, char KEY_L, char KEY_R>
+    NFA<T, KEY_L, KEY_R>::Edge::Edge(char first, char last, int to) : first(first), last(last), to(to)
+    {
+    }
+
+    template<class T, char KEY_L, char KEY_R>
+    NFA<T, KEY_L, KEY_R>::State::State() : data()
+    {
+    }
+
+    template<class T, char KEY_L, char KEY_R>
+    NFA<T, KEY_L, KEY_R>::NFA() : DEFAULT_VAL()
+    {
+        states.emplace_back();
+    }
+
+    template<class T, char KEY_L, char KEY_R>
+    NFA<T, KEY_L, KEY_R>::~NFA() = default;
+
+    template<class T, char KEY_L, char KEY_R>
+    int NFA<T, KEY_L, KEY_R>::add()
+    {
+        states.emplace_back();
+        return static_cast<int>(states.size()) - 1;
+    }
+
+    template<class T, char KEY_L, char KEY_R>
+    void NFA<T, KEY_L, KEY_R>::link(int from, char first, char last, int to)
+    {
+        states[from].edges.emplace_back(first, last, to);
+    }
+
+    template<class T, char KEY_L, char KEY_R>
+    void NFA<T, KEY_L, KEY_R>::link(int from, int to)
+    {
+        states[from].eps.push_back(to);
+    }
+
+    template<class T, char KEY_L, char KEY_R>
+    void NFA<T, KEY_L, KEY_R>::clear()
+    {
+        states.clear();
+        states.emplace_back();
+    }
+
+    // class DFA
+
+    template<class T, char _KEY_L, char _KEY_R>
+    const char DFA<T, _KEY_L, _KEY_R>::KEY_L;
+
+    template<class T, char _KEY_L, char _KEY_R>
+    const char DFA<T, _KEY_L, _KEY_R>::KEY_R;
+
+    template<class T, char _KEY_L, char _KEY_R>
+    const int DFA<T, _KEY_L, _KEY_R>::DEAD;
+
+    template<class T, char _KEY_L, char _KEY_R>
+    const int DFA<T, _KEY_L, _KEY_R>::START;
+
+    template<class T, char _KEY_L, char _KEY_R>
+    const int DFA<T, _KEY_L, _KEY_R>::ABORT;
+
+    template<class T, char _KEY_L, char _KEY_R>
+    DFA<T, _KEY_L, _KEY_R>::DFA() : DEFAULT_VAL()
+    {
+        clear();
+    }
+
+    template<class T, char _KEY_L, char _KEY_R>
+    DFA<T, _KEY_L, _KEY_R>::~DFA() = default;
+
+    template<class T, char _KEY_L, char _KEY_R>
+    void DFA<T, _KEY_L, _KEY_R>::divide(const NFA<T, _KEY_L, _KEY_R>& nfa)
+    {
+        std::vector<const typename NFA<T, _KEY_L, _KEY_R>::Edge*> edges;
+        for (auto itStates = nfa.states.begin(); itStates != nfa.states.end(); ++itStates)
+        {
+            for (auto itEdges = itStates->edges.begin(); itEdges != itStates->edges.end(); ++itEdges)
+            {
+                edges.push_back(&*itEdges);
+            }
+        }
+
+        std::map<std::vector<bool>, int> classes;
+        std::vector<bool> on(edges.size());
+        for (int c = KEY_L; c <= KEY_R; c++)
+        {
+            bool any = false;
+            for (size_t i = 0; i < edges.size(); i++)
+            {
+                on[i] = edges[i]->first <= c && c <= edges[i]->last;
+                any = any || on[i];
+            }
+            if (!any)
+            {
+                continue;
+            }
+            auto it = classes.find(on);
+            if (it == classes.end())
+            {
+                it = classes.emplace(on, classCnt++).first;
+            }
+            classBuffer[static_cast<unsigned char>(c)] = static_cast<unsigned char>(it->second);
+        }
+    }
+
+    template<class T, char _KEY_L, char _KEY_R>
+    void DFA<T, _KEY_L, _KEY_R>::subset(const NFA<T, _KEY_L, _KEY_R>& nfa, std::vector<std::vector<int> >& trans,
+            std::vector<T>& accept) const
+    {
+        std::vector<char> reps(classCnt);
+        for (int c = KEY_R; c >= KEY_L; c--)
+        {
+            reps[classBuffer[static_cast<unsigned char>(c)]] = static_cast<char>(c);
+        }
+
+        std::vector<bool> vis(nfa.states.size());
+        auto closure = [&](std::vector<int>& set)
+        {
+            std::vector<int> stack(set);
+            for (auto it = set.begin(); it != set.end(); ++it)
+            {
+                vis[*it] = true;
+            }
+            while (!stack.empty())
+            {
+                int s = stack.back();
+                stack.pop_back();
+                for (auto it = nfa.states[s].eps.begin(); it != nfa.states[s].eps.end(); ++it)
+                {
+                    if (!vis[*it])
+                    {
+                        vis[*it] = true;
+                        set.push_back(*it);
+                        stack.push_back(*it);
+                    }
+                }
+            }
+            for (auto it = set.begin(); it != set.end(); ++it)
+            {
+                vis[*it] = false;
+            }
+            std::sort(set.begin(), set.end());
+        };
+
+        std::map<std::vector<int>, int> ids;
+        std::vector<std::vector<int> > sets(2);
+        sets[1].push_back(0);
+        closure(sets[1]);
+        ids.emplace(sets[0], DEAD);
+        ids.emplace(sets[1], START);
+
+        for (size_t i = 0; i < sets.size(); i++)
+        {
+            trans.emplace_back(classCnt, DEAD);
+            for (int c = 2; c < classCnt; c++)
+            {
+                std::vector<int> to;
+                for (auto itSet = sets[i].begin(); itSet != sets[i].end(); ++itSet)
+                {
+                    const auto& edges = nfa.states[*itSet].edges;
+                    for (auto itEdges = edges.begin(); itEdges != edges.end(); ++itEdges)
+                    {
+                        if (itEdges->first <= reps[c] && reps[c] <= itEdges->last && !vis[itEdges->to])
+                        {
+                            vis[itEdges->to] = true;
+                            to.push_back(itEdges->to);
+                        }
+                    }
+                }
+                for (auto it = to.begin(); it != to.end(); ++it)
+                {
+                    vis[*it] = false;
+                }
+                closure(to);
+                auto it = ids.find(to);
+                if (it == ids.end())
+                {
+                    it = ids.emplace(to, static_cast<int>(sets.size())).first;
+                    sets.push_back(to);
+                }
+                trans[i][c] = it->second;
+            }
+
+            accept.push_back(DEFAULT_VAL);
+            for (auto it = sets[i].begin(); it != sets[i].end(); ++it)
+            {
+                if (!(nfa.states[*it].data == DEFAULT_VAL))
+                {
+                    accept.back() = nfa.states[*it].data;
+                    break;
+                }
+            }
+        }
+    }
+
+    template<class T, char _KEY_L, char _KEY_R>
+    int DFA<T, _KEY_L, _KEY_R>::minimize(const std::vector<std::vector<int> >& trans, const std::vector<T>& accept,
+            std::vector<int>& block) const
+    {
+        int n = static_cast<int>(trans.size());
+        std::vector<std::vector<int> > blocks;
+        block.assign(n, -1);
+        for (int s = 0; s < n; s++)
+        {
+            for (size_t b = 0; b < blocks.size(); b++)
+            {
+                if (accept[blocks[b].front()] == accept[s])
+                {
+                    block[s] = static_cast<int>(b);
+                    break;
+                }
+            }
+            if (block[s] == -1)
+            {
+                block[s] = static_cast<int>(blocks.size());
+                blocks.emplace_back();
+            }
+            blocks[block[s]].push_back(s);
+        }
+
+        std::vector<std::vector<std::vector<int> > > inv(classCnt, std::vector<std::vector<int> >(n));
+        for (int s = 0; s < n; s++)
+        {
+            for (int c = 2; c < classCnt; c++)
+            {
+                inv[c][trans[s][c]].push_back(s);
+            }
+        }
+
+        std::vector<int> work;
+        std::vector<bool> inWork(blocks.size(), true);
+        for (size_t b = 0; b < blocks.size(); b++)
+        {
+            work.push_back(static_cast<int>(b));
+        }
+
+        std::vector<bool> mark(n);
+        std::vector<int> cnt(blocks.size());
+        while (!work.empty())
+        {
+            std::vector<int> splitter(blocks[work.back()]);
+            inWork[work.back()] = false;
+            work.pop_back();
+
+            for (int c = 2; c < classCnt; c++)
+            {
+                std::vector<int> from;
+                std::vector<int> touched;
+                for (auto itSplitter = splitter.begin(); itSplitter != splitter.end(); ++itSplitter)
+                {
+                    for (auto it = inv[c][*itSplitter].begin(); it != inv[c][*itSplitter].end(); ++it)
+                    {
+                        if (!mark[*it])
+                        {
+                            mark[*it] = true;
+                            from.push_back(*it);
+                            if (cnt[block[*it]]++ == 0)
+                            {
+                                touched.push_back(block[*it]);
+                            }
+                        }
+                    }
+                }
+
+                for (auto itTouched = touched.begin(); itTouched != touched.end(); ++itTouched)
+                {
+                    int b = *itTouched;
+                    if (cnt[b] < static_cast<int>(blocks[b].size()))
+                    {
+                        int nb = static_cast<int>(blocks.size());
+                        blocks.emplace_back();
+                        std::vector<int> rest;
+                        for (auto it = blocks[b].begin(); it != blocks[b].end(); ++it)
+                        {
+                            if (mark[*it])
+                            {
+                                block[*it] = nb;
+                                blocks[nb].push_back(*it);
+                            }
+                            else
+                            {
+                                rest.push_back(*it);
+                            }
+                        }
+                        blocks[b].swap(rest);
+                        cnt.push_back(0);
+
+                        if (inWork[b])
+                        {
+                            inWork.push_back(true);
+                            work.push_back(nb);
+                        }
+                        else
+                        {
+                            int smaller = blocks[nb].size() < blocks[b].size() ? nb : b;
+                            inWork.push_back(false);
+                            inWork[smaller] = true;
+                            work.push_back(smaller);
+                        }
+                    }
+                    cnt[b] = 0;
+                }
+
+                for (auto it = from.begin(); it != from.end(); ++it)
+                {
+                    mark[*it] = false;
+                }
+            }
+        }
+        return static_cast<int>(blocks.size());
+    }
+
+    template<class T, char _KEY_L, char _KEY_R>
+    void DFA<T, _KEY_L, _KEY_R>::compress()
+    {
+        std::map<std::vector<int>, int> columns;
+        std::vector<int> newClass(classCnt);
+        int n = size();
+        int newCnt = 2;
+        newClass[0] = 0;
+        newClass[1] = 1;
+        columns.emplace(std::vector<int>(n, DEAD), 0);
+        for (int c = 2; c < classCnt; c++)
+        {
+            std::vector<int> column(n);
+            for (int s = 0; s < n; s++)
+            {
+                column[s] = nextBuffer[s * classCnt + c];
+            }
+            auto it = columns.find(column);
+            if (it == columns.end())
+            {
+                it = columns.emplace(column, newCnt++).first;
+            }
+            newClass[c] = it->second;
+        }
+
+        std::vector<int> newNext(n * newCnt);
+        for (int s = 0; s < n; s++)
+        {
+            for (int c = 0; c < classCnt; c++)
+            {
+                newNext[s * newCnt + newClass[c]] = nextBuffer[s * classCnt + c];
+            }
+        }
+        for (int i = 0; i < 256; i++)
+        {
+            classBuffer[i] = static_cast<unsigned char>(newClass[classBuffer[i]]);
+        }
+        nextBuffer.swap(newNext);
+        classCnt = newCnt;
+    }
+
+    template<class T, char _KEY_L, char _KEY_R>
+    void DFA<T, _KEY_L, _KEY_R>::build(const NFA<T, _KEY_L, _KEY_R>& nfa)
+    {
+        clear();
+        divide(nfa);
+
+        std::vector<std::vector<int> > trans;
+        std::vector<T> accept;
+        subset(nfa, trans, accept);
+
+        std::vector<int> block;
+        int blockCnt = minimize(trans, accept, block);
+
+        // dead & start first, then the other blocks in order of their first states
+        std::vector<int> row(blockCnt, -1);
+        std::vector<int> rep(blockCnt, -1);
+        std::vector<int> order;
+        order.push_back(block[DEAD]);
+        order.push_back(block[START]);
+        row[block[DEAD]] = DEAD;
+        if (row[block[START]] == -1)
+        {
+            row[block[START]] = START;
+        }
+        for (int s = 0; s < static_cast<int>(trans.size()); s++)
+        {
+            if (rep[block[s]] == -1)
+            {
+                rep[block[s]] = s;
+            }
+            if (row[block[s]] == -1)
+            {
+                row[block[s]] = static_cast<int>(order.size());
+                order.push_back(block[s]);
+            }
+        }
+
+        int n = static_cast<int>(order.size());
+        stateCnt = n;
+        nextBuffer.assign(n * classCnt, DEAD);
+        dataBuffer.assign(n, DEFAULT_VAL);
+        for (int r = START; r < n; r++)
+        {
+            int s = rep[order[r]];
+            nextBuffer[r * classCnt + 1] = ABORT;
+            for (int c = 2; c < classCnt; c++)
+            {
+                nextBuffer[r * classCnt + c] = row[block[trans[s][c]]];
+            }
+            dataBuffer[r] = accept[s];
+        }
+
+        compress();
+        bind();
+    }
+
+    template<class T, char _KEY_L, char _KEY_R>
+    void DFA<T, _KEY_L, _KEY_R>::bind()
+    {
+        classOf = classBuffer.data();
+        next = nextBuffer.data();
+        data = dataBuffer.data();
+    }
+
+    template<class T, char _KEY_L, char _KEY_R>
+    void DFA<T, _KEY_L, _KEY_R>::assign(const unsigned char* classOf, int classCnt, const int* next,
+            const T* data, int stateCnt)
+    {
+        classBuffer.clear();
+        nextBuffer.clear();
+        dataBuffer.clear();
+        this->classOf = classOf;
+        this->classCnt = classCnt;
+        this->next = next;
+        this->data = data;
+        this->stateCnt = stateCnt;
+    }
+
+    template<class T, char _KEY_L, char _KEY_R>
+    const T& DFA<T, _KEY_L, _KEY_R>::cfind(const char* key, int len) const
+    {
+        int p = START;
+        for (const char* end = key + len; key != end; key++)
+        {
+            p = move(p, *key);
+            if (p <= DEAD)
+            {
+                return DEFAULT_VAL;
+            }
+        }
+        return data[p];
+    }
+
+    template<class T, char _KEY_L, char _KEY_R>
+    bool DFA<T, _KEY_L, _KEY_R>::words(int state, std::string& word, const char* tail, const T& except,
+            const std::vector<bool>& useful, std::vector<std::string>& keys, std::vector<T>& vals) const
+    {
+        // a word longer than the count of states goes round a loop
+        if (static_cast<int>(word.size()) > stateCnt)
+        {
+            return false;
+        }
+        if (data[state] != DEFAULT_VAL && data[state] != except)
+        {
+            keys.push_back(word);
+            vals.push_back(data[state]);
+        }
+        for (const char* c = tail; *c != '\0'; c++)
+        {
+            int next = move(state, *c);
+            if (next > DEAD && useful[next])
+            {
+                word.push_back(*c);
+                if (!words(next, word, tail, except, useful, keys, vals))
+                {
+                    return false;
+                }
+                word.pop_back();
+            }
+        }
+        return true;
+    }
+
+    template<class T, char _KEY_L, char _KEY_R>
+    bool DFA<T, _KEY_L, _KEY_R>::words(const char* head, const char* tail, const T& except,
+            std::vector<std::string>& keys, std::vector<T>& vals) const
+    {
+        // a state is useful if a word is reached from it on chars in tail
+        int n = size();
+        std::vector<bool> useful(n, false);
+        for (bool changed = true; changed; )
+        {
+            changed = false;
+            for (int s = START; s < n; s++)
+            {
+                bool res = data[s] != DEFAULT_VAL && data[s] != except;
+                for (const char* c = tail; !res && *c != '\0'; c++)
+                {
+                    int next = move(s, *c);
+                    res = next > DEAD && useful[next];
+                }
+                if (res && !useful[s])
+                {
+                    useful[s] = true;
+                    changed = true;
+                }
+            }
+        }
+
+        keys.clear();
+        vals.clear();
+        std::string word;
+        for (const char* c = head; *c != '\0'; c++)
+        {
+            int next = move(START, *c);
+            if (next > DEAD && useful[next])
+            {
+                word.assign(1, *c);
+                if (!words(next, word, tail, except, useful, keys, vals))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    template<class T, char _KEY_L, char _KEY_R>
+    int DFA<T, _KEY_L, _KEY_R>::size() const
+    {
+        return stateCnt;
+    }
+
+    template<class T, char _KEY_L, char _KEY_R>
+    void DFA<T, _KEY_L, _KEY_R>::clear()
+    {
+        classCnt = 2;
+        stateCnt = 2;
+        classBuffer.resize(256);
+        for (int i = 0; i < 256; i++)
+        {
+            classBuffer[i] = static_cast<char>(i) > KEY_R ? 1 : 0;
+        }
+        nextBuffer.assign(stateCnt * classCnt, DEAD);
+        nextBuffer[START * classCnt + 1] = ABORT;
+        dataBuffer.assign(stateCnt, DEFAULT_VAL);
+        bind();
+    }
+
+    template<class T, char _KEY_L, char _KEY_R>
+    void DFA<T, _KEY_L, _KEY_R>::print(FILE* fp) const
+    {
+        int n = size();
+        for (int i = 0; i < n; i++)
+        {
+            fprintf(fp, "%d<%d>: ", i, static_cast<int>(data[i]));
+            for (int c = KEY_L; c <= KEY_R; c++)
+            {
+                if (move(i, static_cast<char>(c)) > DEAD)
+                {
+                    fprintf(fp, "%c:%d ", c, move(i, static_cast<char>(c)));
+                }
+            }
+            fprintf(fp, "\n");
+        }
+    }
+}
+
+#endif // _SCC_DFA_TCC_
@@ -0,0 +1,136 @@
+/*
+    Implementation of hash table.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _SCC_HASHTABLE_H_
+#define _SCC_HASHTABLE_H_
+
+#include <cstdio>
+
+#include <vector>
+
+namespace scc
+{
+    // FNV-1a, which the lexers compute on the fly for identifiers
+
+    const unsigned FNV_OFFSET = 2166136261u;
+
+    const unsigned FNV_PRIME = 16777619u;
+
+    inline unsigned fnvStep(unsigned hash, char c)
+    {
+        return (hash ^ static_cast<unsigned char>(c)) * FNV_PRIME;
+    }
+
+    inline unsigned fnvHash(const char* key, int len)
+    {
+        unsigned hash = FNV_OFFSET;
+        for (const char* end = key + len; key != end; key++)
+        {
+            hash = fnvStep(hash, *key);
+        }
+        return hash;
+    }
+
+    /**
+     * Open addressing hash table with linear probing, whose keys are copied in.
+     * A slot is in use only if its stamp is the current one, so clear() is O(1)
+     */
+    template<class T>
+    class HashTable
+    {
+    protected:
+
+        struct Slot
+        {
+            unsigned hash;
+            unsigned stamp;
+            int keyPos;
+            int keyLen;
+            T data;
+
+            Slot();
+        };
+
+        /**
+         * Double the slots, dropping those not in use
+         */
+        void grow();
+
+        int index(unsigned hash) const
+        {
+            return static_cast<int>((hash ^ (hash >> 15)) & static_cast<unsigned>(mask));
+        }
+
+        std::vector<Slot> slots;
+
+        // keys of the slots in use
+        std::vector<char> keys;
+
+        unsigned stamp;
+
+        int mask;
+
+        int cnt;
+
+    public:
+
+        const T DEFAULT_VAL;
+
+        /**
+         * @param capacity: initial count of slots, a power of 2
+         */
+        explicit HashTable(int capacity = 64);
+
+        virtual ~HashTable();
+
+        /**
+         * @param hash: fnvHash(key, len)
+         * @return the data of key, which is added if not found
+         */
+        T& at(const char* key, int len, unsigned hash);
+
+        T& at(const char* key, int len);
+
+        /**
+         * @return the data of key, or DEFAULT_VAL if not found
+         */
+        const T& cfind(const char* key, int len, unsigned hash) const;
+
+        const T& cfind(const char* key, int len) const;
+
+        /**
+         * @return count of keys
+         */
+        int size() const;
+
+        /**
+         * @return bytes allocated
+         */
+        size_t memory() const;
+
+        void clear();
+
+        void print(FILE* fp) const;
+    };
+}
+
+#endif // _SCC_HASHTABLE_H_
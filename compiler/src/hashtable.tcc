@@ -0,0 +1,172 @@
+/*
+    Implementation of hash table.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _SCC_HASHTABLE_TCC_
+#define _SCC_HASHTABLE_TCC_
+
+#include "hashtable.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include <utility>
+#include <vector>
+
+namespace scc
+{
+    // class HashTable
+
+    template<class T>
+    HashTable<T>::Slot::Slot() : hash(0), stamp(0), keyPos(0), keyLen(0), data()
+    {
+    }
+
+    template<class T>
+    HashTable<T>::HashTable(int capacity) : slots(capacity), stamp(1), mask(capacity - 1), cnt(0),
+            DEFAULT_VAL()
+    {
+    }
+
+    template<class T>
+    HashTable<T>::~HashTable() = default;
+
+    template<class T>
+    void HashTable<T>::grow()
+    {
+        std::vector<Slot> buffer(slots.size() * 2);
+        slots.swap(buffer);
+        mask = static_cast<int>(slots.size()) - 1;
+        for (Slot& slot : buffer)
+        {
+            if (slot.stamp == stamp)
+            {
+                int i = index(slot.hash);
+                while (slots[i].stamp == stamp)
+                {
+                    i = (i + 1) & mask;
+                }
+                slots[i] = std::move(slot);
+            }
+        }
+    }
+
+    template<class T>
+    T& HashTable<T>::at(const char* key, int len, unsigned hash)
+    {
+        // no more than 3/4 of the slots are in use
+        if ((cnt + 1) * 4 > static_cast<int>(slots.size()) * 3)
+        {
+            grow();
+        }
+        int i = index(hash);
+        while (slots[i].stamp == stamp)
+        {
+            Slot& slot = slots[i];
+            if (slot.hash == hash && slot.keyLen == len && memcmp(keys.data() + slot.keyPos, key, len) == 0)
+            {
+                return slot.data;
+            }
+            i = (i + 1) & mask;
+        }
+        Slot& slot = slots[i];
+        slot.hash = hash;
+        slot.stamp = stamp;
+        slot.keyPos = static_cast<int>(keys.size());
+        slot.keyLen = len;
+        slot.data = T();
+        keys.insert(keys.end(), key, key + len);
+        cnt++;
+        return slot.data;
+    }
+
+    template<class T>
+    T& HashTable<T>::at(const char* key, int len)
+    {
+        return at(key, len, fnvHash(key, len));
+    }
+
+    template<class T>
+    const T& HashTable<T>::cfind(const char* key, int len, unsigned hash) const
+    {
+        int i = index(hash);
+        while (slots[i].stamp == stamp)
+        {
+            const Slot& slot = slots[i];
+            if (slot.hash == hash && slot.keyLen == len && memcmp(keys.data() + slot.keyPos, key, len) == 0)
+            {
+                return slot.data;
+            }
+            i = (i + 1) & mask;
+        }
+        return DEFAULT_VAL;
+    }
+
+    template<class T>
+    const T& HashTable<T>::cfind(const char* key, int len) const
+    {
+        return cfind(key, len, fnvHash(key, len));
+    }
+
+    template<class T>
+    int HashTable<T>::size() const
+    {
+        return cnt;
+    }
+
+    template<class T>
+    size_t HashTable<T>::memory() const
+    {
+        return slots.capacity() * sizeof(Slot) + keys.capacity();
+    }
+
+    template<class T>
+    void HashTable<T>::clear()
+    {
+        if (++stamp == 0)
+        {
+            // once in 2^32 clears, the old stamps may come back
+            for (Slot& slot : slots)
+            {
+                slot.stamp = 0;
+            }
+            stamp = 1;
+        }
+        keys.clear();
+        cnt = 0;
+    }
+
+    template<class T>
+    void HashTable<T>::print(FILE* fp) const
+    {
+        int n = slots.size();
+        for (int i = 0; i < n; i++)
+        {
+            if (slots[i].stamp == stamp)
+            {
+                fprintf(fp, "%d<%d>: %.*s\n", i, static_cast<int>(slots[i].data), slots[i].keyLen,
+                        keys.data() + slots[i].keyPos);
+            }
+        }
+    }
+}
+
+#endif // _SCC_HASHTABLE_TCC_
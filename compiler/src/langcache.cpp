@@ -0,0 +1,271 @@
+/*
+    Cache of lexer tables built from lang files of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "langcache.h"
+#include "lexer.h"
+#include "define.h"
+
+#include "../../common/src/exception.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <vector>
+
+#ifndef WINDOWS
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+namespace scc
+{
+    std::string cacheDir()
+    {
+        std::string dir;
+#ifndef WINDOWS
+        const char* base = getenv("XDG_CACHE_HOME");
+        if (base != nullptr && base[0] != '\0')
+        {
+            dir = base;
+        }
+        else if ((base = getenv("HOME")) != nullptr && base[0] != '\0')
+        {
+            dir = base;
+            dir += "/.cache";
+        }
+        else
+        {
+            return dir;
+        }
+        dir += "/scc";
+#endif
+        return dir;
+    }
+
+    void makeDirs(const std::string& dir)
+    {
+#ifndef WINDOWS
+        for (size_t i = dir.find('/', 1); i != std::string::npos; i = dir.find('/', i + 1))
+        {
+            mkdir(dir.substr(0, i).c_str(), 0755);
+        }
+        mkdir(dir.c_str(), 0755);
+#endif
+    }
+
+    void fnv(uint64_t& hash, const void* data, size_t size)
+    {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++)
+        {
+            hash = (hash ^ p[i]) * 1099511628211ull;
+        }
+    }
+
+    FILE* createFile(const std::string& path, std::string& tmpPath)
+    {
+#ifndef WINDOWS
+        // a unique name, as threads of one process may write the same path at once
+        std::vector<char> name(path.begin(), path.end());
+        const char suffix[] = ".XXXXXX";
+        name.insert(name.end(), suffix, suffix + sizeof(suffix));
+        int fd = mkstemp(name.data());
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+        tmpPath = name.data();
+        FILE* fp = fdopen(fd, "wb");
+        if (fp == nullptr)
+        {
+            ::close(fd);
+            remove(tmpPath.c_str());
+        }
+        return fp;
+#else
+        return nullptr;
+#endif
+    }
+
+    bool commitFile(FILE* fp, const std::string& tmpPath, const std::string& path, bool ok)
+    {
+        ok = fclose(fp) == 0 && ok;
+        if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0)
+        {
+            remove(tmpPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // class LangCache
+
+    const char LangCache::MAGIC[8] = {'S', 'C', 'C', 'L', 'A', 'N', 'G', '\0'};
+
+    LangCache::LangCache() : hash(0)
+    {
+    }
+
+    bool LangCache::load(const char* langFileName)
+    {
+        buffer.close();
+        path.clear();
+        hash = FNV_BASIS;
+#ifndef WINDOWS
+        path = cacheDir();
+        if (path.empty())
+        {
+            return false;
+        }
+
+        FILE* fp = fopen(langFileName, "rb");
+        if (fp == nullptr)
+        {
+            path.clear();
+            return false;
+        }
+        unsigned char chunk[4096];
+        size_t len;
+        while ((len = fread(chunk, 1, sizeof(chunk), fp)) > 0)
+        {
+            fnv(hash, chunk, len);
+        }
+        fclose(fp);
+
+        char name[32];
+        snprintf(name, sizeof(name), "/lang-%016llx", static_cast<unsigned long long>(hash));
+        path += name;
+#else
+        return false;
+#endif
+
+        try
+        {
+            buffer.open(path.c_str());
+        }
+        catch (const FileError& e)
+        {
+            return false;
+        }
+
+        const char* p = buffer.begin();
+        size_t size = buffer.end() - p;
+        const int typeCnt = static_cast<int>(TokenType::END);
+        Header header;
+        if (size < sizeof(Header))
+        {
+            return false;
+        }
+        memcpy(&header, p, sizeof(Header));
+        if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION
+                || header.hash != hash || header.typeCnt != static_cast<uint32_t>(typeCnt)
+                || header.typeNameMax != TYPE_NAME_MAX || header.classCnt < 2 || header.classCnt > 256
+                || header.stateCnt < 2 || header.stateCnt > (1 << 20))
+        {
+            return false;
+        }
+        size_t n = header.stateCnt;
+        size_t m = header.classCnt;
+        if (size != sizeof(Header) + n * m * sizeof(int) + n * sizeof(TokenType) + 256
+                + typeCnt * TYPE_NAME_MAX)
+        {
+            return false;
+        }
+
+        // the cache may be damaged, so check every entry before using it
+        p += sizeof(Header);
+        const int* next = reinterpret_cast<const int*>(p);
+        p += n * m * sizeof(int);
+        const TokenType* data = reinterpret_cast<const TokenType*>(p);
+        p += n * sizeof(TokenType);
+        const unsigned char* classOf = reinterpret_cast<const unsigned char*>(p);
+        p += 256;
+        for (size_t i = 0; i < n * m; i++)
+        {
+            if (next[i] < lexDFA.ABORT || next[i] >= header.stateCnt)
+            {
+                return false;
+            }
+        }
+        for (size_t i = 0; i < n; i++)
+        {
+            if (static_cast<int>(data[i]) < 0 || static_cast<int>(data[i]) >= typeCnt)
+            {
+                return false;
+            }
+        }
+        for (int i = 0; i < 256; i++)
+        {
+            if (classOf[i] >= m)
+            {
+                return false;
+            }
+        }
+        for (int i = 0; i < typeCnt; i++)
+        {
+            if (memchr(p + i * TYPE_NAME_MAX, '\0', TYPE_NAME_MAX) == nullptr)
+            {
+                return false;
+            }
+        }
+
+        memcpy(typeName, p, sizeof(typeName));
+        lexDFA.assign(classOf, header.classCnt, next, data, header.stateCnt);
+        return buildKeywords();
+    }
+
+    void LangCache::save() const
+    {
+#ifndef WINDOWS
+        if (path.empty())
+        {
+            return;
+        }
+        makeDirs(path.substr(0, path.rfind('/')));
+
+        std::string tmpPath;
+        FILE* fp = createFile(path, tmpPath);
+        if (fp == nullptr)
+        {
+            return;
+        }
+
+        Header header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.typeCnt = static_cast<uint32_t>(TokenType::END);
+        header.hash = hash;
+        header.typeNameMax = TYPE_NAME_MAX;
+        header.classCnt = lexDFA.classCnt;
+        header.stateCnt = lexDFA.size();
+        size_t n = header.stateCnt;
+        size_t m = header.classCnt;
+
+        bool ok = fwrite(&header, sizeof(header), 1, fp) == 1
+                && fwrite(lexDFA.next, sizeof(int), n * m, fp) == n * m
+                && fwrite(lexDFA.data, sizeof(TokenType), n, fp) == n
+                && fwrite(lexDFA.classOf, 1, 256, fp) == 256
+                && fwrite(typeName, sizeof(typeName), 1, fp) == 1;
+        commitFile(fp, tmpPath, path, ok);
+#endif
+    }
+}
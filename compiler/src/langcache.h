@@ -0,0 +1,127 @@
+/*
+    Cache of lexer tables built from lang files of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _SCC_LANGCACHE_H_
+#define _SCC_LANGCACHE_H_
+
+#include "source.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace scc
+{
+    /**
+     * @return $XDG_CACHE_HOME/scc or ~/.cache/scc, empty if neither is known or on Windows
+     */
+    std::string cacheDir();
+
+    /**
+     * Make the directory and those above it
+     */
+    void makeDirs(const std::string& dir);
+
+    /**
+     * Offset basis of the 64-bit FNV-1a hash
+     */
+    const uint64_t FNV_BASIS = 14695981039346656037ull;
+
+    /**
+     * Fold data into the 64-bit FNV-1a hash
+     */
+    void fnv(uint64_t& hash, const void* data, size_t size);
+
+    /**
+     * Create a temporary file of a unique name beside path, to be renamed to it by commitFile,
+     * so that others never see a part of the file
+     *
+     * @param tmpPath: name of the temporary file
+     * @return the temporary file, nullptr if fail or on Windows
+     */
+    FILE* createFile(const std::string& path, std::string& tmpPath);
+
+    /**
+     * Close the temporary file created by createFile, then rename it to path if ok or remove it
+     *
+     * @param ok: whether everything is written
+     * @return whether path is replaced
+     */
+    bool commitFile(FILE* fp, const std::string& tmpPath, const std::string& path, bool ok);
+
+    /**
+     * Cache of lexDFA and typeName built from a lang file, named by the hash of its content
+     * under $XDG_CACHE_HOME/scc or ~/.cache/scc, so that a changed lang file never hits
+     */
+    class LangCache
+    {
+    protected:
+
+        static const char MAGIC[8];
+
+        /**
+         * Version of the format and of the DFA generator, a cache of another version is rebuilt
+         */
+        static const uint32_t VERSION = 1;
+
+        struct Header
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t typeCnt;
+            uint64_t hash;
+            int32_t typeNameMax;
+            int32_t classCnt;
+            int32_t stateCnt;
+            int32_t reserved;
+        };
+
+        SourceBuffer buffer;
+
+        uint64_t hash;
+
+        // empty if there is no cache directory or the lang file cannot be read
+        std::string path;
+
+    public:
+
+        LangCache();
+
+        /**
+         * Map the cache of the lang file, point lexDFA to it and build lexKeywords,
+         * where lexDFA must be used no longer than this LangCache lives
+         *
+         * @param langFileName: name of lang file, whose content is hashed
+         * @return whether a valid cache is found
+         */
+        bool load(const char* langFileName);
+
+        /**
+         * Save lexDFA and typeName built by readLang from the lang file last loaded,
+         * failing silently
+         */
+        void save() const;
+    };
+}
+
+#endif // _SCC_LANGCACHE_H_
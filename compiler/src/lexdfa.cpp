@@ -0,0 +1,575 @@
+/*
+    Tables of the lexer generated from sc.lang by lang2dfa.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "lexer.h"
+
+namespace scc
+{
+    char typeName[static_cast<unsigned>(TokenType::END)][TYPE_NAME_MAX] =
+    {
+        "NONE",
+        "INTCON",
+        "CHARCON",
+        "STRCON",
+        "CONSTTK",
+        "INTTK",
+        "CHARTK",
+        "VOIDTK",
+        "MAINTK",
+        "IFTK",
+        "ELSETK",
+        "DOTK",
+        "WHILETK",
+        "FORTK",
+        "SCANFTK",
+        "PRINTFTK",
+        "RETURNTK",
+        "PLUS",
+        "MINU",
+        "MULT",
+        "DIV",
+        "LSS",
+        "LEQ",
+        "GRE",
+        "GEQ",
+        "EQL",
+        "NEQ",
+        "ASSIGN",
+        "SEMICN",
+        "COMMA",
+        "LPARENT",
+        "RPARENT",
+        "LBRACK",
+        "RBRACK",
+        "LBRACE",
+        "RBRACE",
+        "IDENFR",
+        "COMMENT",
+        "INTERR",
+        "CHARERR",
+        "FEOF",
+    };
+
+    extern constexpr int LANG_CLASS_CNT = 42;
+
+    extern constexpr int LANG_STATE_CNT = 85;
+
+    extern constexpr unsigned char LANG_CLASS_OF[256] =
+    {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        2, 3, 4, 2, 2, 2, 2, 5, 6, 7, 8, 9, 10, 11, 2, 12,
+        13, 14, 14, 14, 14, 14, 14, 14, 14, 14, 2, 15, 16, 17, 18, 2,
+        2, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19,
+        19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 19, 20, 2, 21, 2, 19,
+        2, 22, 19, 23, 24, 25, 26, 19, 27, 28, 19, 19, 29, 30, 31, 32,
+        33, 19, 34, 35, 36, 37, 38, 39, 19, 19, 19, 40, 2, 41, 2, 1,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    };
+
+    extern constexpr int LANG_NEXT[3570] =
+    {
+        // 0
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 1
+        0, -1, 0, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+        15, 16, 17, 18, 19, 20, 18, 21, 22, 23, 24, 18, 25, 18, 26, 18,
+        18, 27, 28, 29, 18, 18, 30, 31, 32, 33,
+        // 2
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 34, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 3
+        0, -1, 3, 3, 35, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+        3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+        3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
+        // 4
+        0, -1, 36, 36, 36, 36, 36, 36, 37, 37, 36, 37, 37, 37, 37, 36,
+        36, 36, 36, 37, 36, 36, 37, 37, 37, 37, 37, 37, 37, 37, 37, 37,
+        37, 37, 37, 37, 37, 37, 37, 37, 36, 36,
+        // 5
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 6
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 7
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 8
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 9
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 10
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 11
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 38, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 12
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 39, 39, 0,
+        0, 0, 0, 39, 0, 0, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39,
+        39, 39, 39, 39, 39, 39, 39, 39, 0, 0,
+        // 13
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 13, 13, 0,
+        0, 0, 0, 39, 0, 0, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39,
+        39, 39, 39, 39, 39, 39, 39, 39, 0, 0,
+        // 14
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 15
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 40, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 16
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 41, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 17
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 42, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 18
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 19
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 20
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 21
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 43, 18, 18, 18, 18,
+        44, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 22
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        45, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 23
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 46, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 24
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        47, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 25
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 48, 18, 18, 18, 18, 49,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 26
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 50, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 27
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 51, 18, 18, 18, 18, 18, 0, 0,
+        // 28
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 52, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 29
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 53, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 30
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        54, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 31
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 55, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 32
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 33
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 34
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 35
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 36
+        0, -1, 0, 0, 0, 56, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 37
+        0, -1, 0, 0, 0, 57, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 38
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 39
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 39, 39, 0,
+        0, 0, 0, 39, 0, 0, 39, 39, 39, 39, 39, 39, 39, 39, 39, 39,
+        39, 39, 39, 39, 39, 39, 39, 39, 0, 0,
+        // 40
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 41
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 42
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 43
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 58, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 44
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 59,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 45
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 46
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 60, 18, 18, 18, 18, 0, 0,
+        // 47
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 61, 18, 18, 18, 18, 18, 0, 0,
+        // 48
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 49
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 62, 18, 18, 18, 0, 0,
+        // 50
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 63, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 51
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 64, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 52
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 65, 18, 18, 18, 0, 0,
+        // 53
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 66, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 54
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 67, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 55
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 68, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 56
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 57
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        // 58
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 69, 18, 18, 18, 18, 18, 0, 0,
+        // 59
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 70, 18, 18, 18, 18, 0, 0,
+        // 60
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 71, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 61
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 62
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 63
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 72,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 64
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 73,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 65
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 74, 18, 18, 0, 0,
+        // 66
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 75,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 67
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 76, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 68
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 77, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 69
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 70
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 78, 18, 18, 18, 0, 0,
+        // 71
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 72
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 73
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 79, 18, 18, 18, 0, 0,
+        // 74
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 80, 18, 18, 18, 18, 18, 0, 0,
+        // 75
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 81, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 76
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 77
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 82, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 78
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 79
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 83, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 80
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 84,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 81
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 82
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 83
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+        // 84
+        0, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 18, 18, 0,
+        0, 0, 0, 18, 0, 0, 18, 18, 18, 18, 18, 18, 18, 18, 18, 18,
+        18, 18, 18, 18, 18, 18, 18, 18, 0, 0,
+    };
+
+    extern constexpr TokenType LANG_DATA[85] =
+    {
+        TokenType::NONE,
+        TokenType::NONE,
+        TokenType::NONE,
+        TokenType::NONE,
+        TokenType::NONE,
+        TokenType::LPARENT,
+        TokenType::RPARENT,
+        TokenType::MULT,
+        TokenType::PLUS,
+        TokenType::COMMA,
+        TokenType::MINU,
+        TokenType::DIV,
+        TokenType::INTCON,
+        TokenType::INTCON,
+        TokenType::SEMICN,
+        TokenType::LSS,
+        TokenType::ASSIGN,
+        TokenType::GRE,
+        TokenType::IDENFR,
+        TokenType::LBRACK,
+        TokenType::RBRACK,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::LBRACE,
+        TokenType::RBRACE,
+        TokenType::NEQ,
+        TokenType::STRCON,
+        TokenType::NONE,
+        TokenType::NONE,
+        TokenType::COMMENT,
+        TokenType::INTERR,
+        TokenType::LEQ,
+        TokenType::EQL,
+        TokenType::GEQ,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::DOTK,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IFTK,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::CHARERR,
+        TokenType::CHARCON,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::FORTK,
+        TokenType::INTTK,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::CHARTK,
+        TokenType::IDENFR,
+        TokenType::ELSETK,
+        TokenType::MAINTK,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::VOIDTK,
+        TokenType::IDENFR,
+        TokenType::CONSTTK,
+        TokenType::IDENFR,
+        TokenType::IDENFR,
+        TokenType::SCANFTK,
+        TokenType::WHILETK,
+        TokenType::PRINTFTK,
+        TokenType::RETURNTK,
+    };
+
+    extern constexpr int LANG_KEYWORD_SIZE = 32;
+
+    extern constexpr unsigned LANG_KEYWORD_MULT = 4230764245u;
+
+    extern constexpr TokenType LANG_KEYWORD_DATA[32] =
+    {
+        TokenType::NONE,
+        TokenType::RETURNTK,
+        TokenType::FORTK,
+        TokenType::NONE,
+        TokenType::DOTK,
+        TokenType::NONE,
+        TokenType::ELSETK,
+        TokenType::NONE,
+        TokenType::NONE,
+        TokenType::NONE,
+        TokenType::NONE,
+        TokenType::NONE,
+        TokenType::IFTK,
+        TokenType::INTTK,
+        TokenType::NONE,
+        TokenType::PRINTFTK,
+        TokenType::NONE,
+        TokenType::MAINTK,
+        TokenType::NONE,
+        TokenType::VOIDTK,
+        TokenType::CHARTK,
+        TokenType::NONE,
+        TokenType::CONSTTK,
+        TokenType::NONE,
+        TokenType::NONE,
+        TokenType::NONE,
+        TokenType::WHILETK,
+        TokenType::NONE,
+        TokenType::NONE,
+        TokenType::NONE,
+        TokenType::NONE,
+        TokenType::SCANFTK,
+    };
+
+    extern constexpr int LANG_KEYWORD_OFFSET[33] =
+    {
+        0, 0, 6, 9, 9, 11, 11, 15, 15, 15, 15, 15, 15, 17, 20, 20,
+        26, 26, 30, 30, 34, 38, 38, 43, 43, 43, 43, 48, 48, 48, 48, 48,
+        53,
+    };
+
+    extern constexpr char LANG_KEYWORD_WORDS[] = "returnfordoelseifintprintfmainvoidcharconstwhilescanf";
+}
@@ -20,7 +20,8 @@
 
 #include "lexer.h"
 #include "regexp"
-#include "trie"
+#include "dfa"
+#include "scan.h"
 #include "define.h"
 
 #include "../../common/src/exception.h"
@@ -29,18 +30,26 @@
 #include <cstring>
 #include <cassert>
 
+#include <string>
+#include <vector>
+
 #ifdef CG
 #include "cg.h"
 #endif
 
 namespace scc
 {
-    char typeName[static_cast<unsigned>(TokenType::END)][TYPE_NAME_MAX] = {{'\0'}};
+    DFA<TokenType> lexDFA;
+
+    PerfectHash<TokenType> lexKeywords;
 
-    Trie<TokenType> lexTrie;
+    // chars of identifiers scanned by DFALexer
+    static const char ID_HEAD[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz";
+    static const char ID_TAIL[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz";
 
-    void readLang(const char* fileName, bool buildTrie)
+    bool readLang(const char* fileName, bool buildDFA)
     {
+        bool valid = true;
         FILE* fp;
 #ifdef CG
         fp = fopen(fileName, "w");
@@ -52,14 +61,15 @@ namespace scc
         {
             throw FileError(fileName, "lang");
         }
-        RegExp<TokenType> regExp(lexTrie);
+        NFA<TokenType> nfa;
+        RegExp<TokenType> regExp(nfa);
         const int BUFFER_MAX = 256;
         char buffer[BUFFER_MAX];
         int n = static_cast<int>(TokenType::END);
         for (int i = 0; i < n; i++)
         {
             fscanf(fp, "%[^,],", typeName[i]);
-            if (buildTrie) // TODO: none & //
+            if (buildDFA) // TODO: none & //
             {
                 if (fgetc(fp) == '/')
                 {
@@ -73,6 +83,7 @@ namespace scc
                     {
                         e.setTypeName(typeName[i]);
                         e.print(stderr);
+                        valid = false;
                     }
 
                     // TODO
@@ -84,48 +95,53 @@ namespace scc
             }
         }
         fclose(fp);
+        if (buildDFA)
+        {
+            lexDFA.build(nfa);
+            if (!buildKeywords())
+            {
+                fprintf(stderr, "%s: error: unable to hash keywords\n", fileName);
+                valid = false;
+            }
+        }
+        return valid;
     }
 
-    // class Lexer
+    void loadLang()
+    {
+        lexDFA.assign(LANG_CLASS_OF, LANG_CLASS_CNT, LANG_NEXT, LANG_DATA, LANG_STATE_CNT);
+        lexKeywords.assign(LANG_KEYWORD_SIZE, LANG_KEYWORD_MULT, LANG_KEYWORD_DATA, LANG_KEYWORD_OFFSET,
+                LANG_KEYWORD_WORDS);
+    }
 
-    Lexer::Lexer() : fp(nullptr), fileName(nullptr)
+    bool buildKeywords()
     {
+        std::vector<std::string> keys;
+        std::vector<TokenType> vals;
+        return lexDFA.words(ID_HEAD, ID_TAIL, TokenType::IDENFR, keys, vals) && lexKeywords.build(keys, vals);
     }
 
-    Lexer::~Lexer()
+    // class Lexer
+
+    Lexer::Lexer() : cur(nullptr), end(nullptr), fileName(nullptr)
     {
-        if (fp != nullptr)
-        {
-            fclose(fp);
-        }
     }
 
+    Lexer::~Lexer() = default;
+
     void Lexer::open(const char *fileName)
     {
-        if (strcmp(fileName, "-") == 0)
-        {
-            fp = stdin;
-        }
-        else
-        {
-            fp = fopen(fileName, "r");
-        }
-        if (fp == nullptr)
-        {
-            throw FileError(fileName, "input");
-        }
+        source.open(fileName);
         this->fileName = fileName;
-        ch = fgetc(fp);
+        cur = source.begin();
+        end = source.end();
         row = 1;
     }
 
     void Lexer::close()
     {
-        if (fp != nullptr)
-        {
-            fclose(fp);
-            fp = nullptr;
-        }
+        source.close();
+        cur = end = nullptr;
     }
 
     const char* Lexer::getFileName()
@@ -137,21 +153,14 @@ namespace scc
 
     void TrieLexer::nextToken(Token& token)
     {
-        assert(fp != nullptr);
+        assert(cur != nullptr);
 
         while (true)
         {
-            int p = 0;
+            int p = lexDFA.START;
 
-            while (ch != static_cast<char>(EOF) && (ch <= ' ' || isspace(ch)))
-            {
-                if (ch == '\n')
-                {
-                    ++row;
-                }
-                ch = fgetc(fp);
-            }
-            if (ch == static_cast<char>(EOF))
+            cur = skipSpace(cur, end, row);
+            if (cur == end)
             {
                 token.type = TokenType::FEOF;
                 return;
@@ -159,48 +168,46 @@ namespace scc
 
             token.row = row;
 
-            while (true)
+            // the sentinel '\0' at end never moves
+            const char* first = cur;
+            int next;
+            while ((next = lexDFA.move(p, *cur)) > lexDFA.DEAD)
             {
-                if (ch < lexTrie.KEY_L || ch == static_cast<char>(EOF)) // TODO: merge
-                {
-                    break;
-                }
-                else if (ch > lexTrie.KEY_R)
-                {
-                    return; // TODO: ERROR
-                }
-                else if (lexTrie.nodes[p].son[ch - lexTrie.KEY_L] == 0)
-                {
-                    break;
-                }
-                else
-                {
-                    p = lexTrie.nodes[p].son[ch - lexTrie.KEY_L];
-                }
-                token.val.push_back(ch);
-                ch = fgetc(fp);
+                p = next;
+                ++cur;
+            }
+            if (next == lexDFA.ABORT)
+            {
+                token.val.assign(first, cur);
+                return; // TODO: ERROR
             }
 
-            token.type = lexTrie.nodes[p].data;
+            token.type = lexDFA.data[p];
 
             if (token.type == TokenType::COMMENT)
             {
-                while (ch != '\n' && ch != static_cast<char>(EOF))
+                cur = scanKernels.findEol(cur, end);
+                ++row;
+                if (cur != end)
                 {
-                    ch = fgetc(fp);
+                    ++cur;
                 }
-                ++row;
-                ch = fgetc(fp);
                 token.type = TokenType::NONE;
-                token.val.clear();
                 continue;
             }
 
             if (token.type == TokenType::CHARCON || token.type == TokenType::STRCON
                     || token.type == TokenType::CHARERR)
             {
-                token.val.pop_back();
-                token.val = token.val.substr(1);
+                token.val.assign(first + 1, cur - 1);
+            }
+            else
+            {
+                token.val.assign(first, cur);
+                if (token.type == TokenType::IDENFR)
+                {
+                    token.hash = fnvHash(first, static_cast<int>(cur - first));
+                }
             }
 
             return;
@@ -221,19 +228,12 @@ namespace scc
 
     void DFALexer::nextToken(Token& token)
     {
-        assert(fp != nullptr);
+        assert(cur != nullptr);
 
         while (true)
         {
-            while (ch != static_cast<char>(EOF) && (ch <= ' ' || isspace(ch)))
-            {
-                if (ch == '\n')
-                {
-                    ++row;
-                }
-                ch = fgetc(fp);
-            }
-            if (ch == static_cast<char>(EOF))
+            cur = skipSpace(cur, end, row);
+            if (cur == end)
             {
                 token.type = TokenType::FEOF;
                 return;
@@ -241,11 +241,12 @@ namespace scc
 
             token.row = row;
 
-            switch (ch)
+            // *end is '\0', so peeking at the next char is always safe
+            const char* first = cur;
+            switch (*cur++)
             {
             case '\'':
-                ch = fgetc(fp);
-                if (!(ch == '+' || ch == '-' || ch == '*' || ch == '/' || isAlpha(ch) || isDigit(ch)))
+                if (!(*cur == '+' || *cur == '-' || *cur == '*' || *cur == '/' || isAlpha(*cur) || isDigit(*cur)))
                 {
                     token.type = TokenType::CHARERR;
                 }
@@ -253,72 +254,57 @@ namespace scc
                 {
                     token.type = TokenType::CHARCON;
                 }
-                token.val.push_back(ch);
-                ch = fgetc(fp);
-                if (ch != '\'')
+                token.val.assign(cur, cur + 1);
+                if (cur == end || *++cur != '\'')
                 {
                     token.type = TokenType::NONE;
                     return; // TODO: ERROR
                 }
-                ch = fgetc(fp);
-                break;
+                ++cur;
+                return;
 
             case '"':
-                while ((ch = fgetc(fp)) != '"')
+                cur = scanKernels.findStrEnd(cur, end);
+                token.val.assign(first + 1, cur);
+                if (*cur != '"')
                 {
-                    if (ch < ' ' || ch > static_cast<char>(126) || ch == static_cast<char>(EOF))
-                    {
-                        return; // TODO: ERROR
-                    }
-                    token.val.push_back(ch);
+                    return; // TODO: ERROR
                 }
-                ch = fgetc(fp);
+                ++cur;
                 token.type = TokenType::STRCON;
-                break;
+                return;
 
             case '+':
-                token.val.push_back(ch);
-                ch = fgetc(fp);
                 token.type = TokenType::PLUS;
                 break;
 
             case '-':
-                token.val.push_back(ch);
-                ch = fgetc(fp);
                 token.type = TokenType::MINU;
                 break;
 
             case '*':
-                token.val.push_back(ch);
-                ch = fgetc(fp);
                 token.type = TokenType::MULT;
                 break;
 
             case '/':
-                token.val.push_back(ch);
-                ch = fgetc(fp);
-                if (ch == '/')
+                if (*cur == '/')
                 {
-                    do
-                    {
-                        ch = fgetc(fp);
-                    } while (ch != '\n' && ch != static_cast<char>(EOF));
+                    cur = scanKernels.findEol(cur, end);
                     ++row;
-                    ch = fgetc(fp);
+                    if (cur != end)
+                    {
+                        ++cur;
+                    }
                     token.type = TokenType::NONE;
-                    token.val.clear();
                     continue;
                 }
                 token.type = TokenType::DIV;
                 break;
 
             case '<':
-                token.val.push_back(ch);
-                ch = fgetc(fp);
-                if (ch == '=')
+                if (*cur == '=')
                 {
-                    token.val.push_back(ch);
-                    ch = fgetc(fp);
+                    ++cur;
                     token.type = TokenType::LEQ;
                 }
                 else
@@ -328,12 +314,9 @@ namespace scc
                 break;
 
             case '>':
-                token.val.push_back(ch);
-                ch = fgetc(fp);
-                if (ch == '=')
+                if (*cur == '=')
                 {
-                    token.val.push_back(ch);
-                    ch = fgetc(fp);
+                    ++cur;
                     token.type = TokenType::GEQ;
                 }
                 else
@@ -343,12 +326,9 @@ namespace scc
                 break;
 
             case '=':
-                token.val.push_back(ch);
-                ch = fgetc(fp);
-                if (ch == '=')
+                if (*cur == '=')
                 {
-                    token.val.push_back(ch);
-                    ch = fgetc(fp);
+                    ++cur;
                     token.type = TokenType::EQL;
                 }
                 else
@@ -358,123 +338,105 @@ namespace scc
                 break;
 
             case '!':
-                token.val.push_back(ch);
-                ch = fgetc(fp);
-                if (ch != '=')
+                if (*cur != '=')
                 {
+                    token.val.assign(first, cur);
                     return;
                 }
-                token.val.push_back(ch);
-                ch = fgetc(fp);
+                ++cur;
                 token.type = TokenType::NEQ;
                 break;
 
             case ';':
-                token.val.push_back(ch);
-                ch = fgetc(fp);
                 token.type = TokenType::SEMICN;
                 break;
 
             case ',':
-                token.val.push_back(ch);
-                ch = fgetc(fp);
                 token.type = TokenType::COMMA;
                 break;
 
             case '(':
-                token.val.push_back(ch);
-                ch = fgetc(fp);
                 token.type = TokenType::LPARENT;
                 break;
 
             case ')':
-                token.val.push_back(ch);
-                ch = fgetc(fp);
                 token.type = TokenType::RPARENT;
                 break;
 
             case '[':
-                token.val.push_back(ch);
-                ch = fgetc(fp);
                 token.type = TokenType::LBRACK;
                 break;
 
             case ']':
-                token.val.push_back(ch);
-                ch = fgetc(fp);
                 token.type = TokenType::RBRACK;
                 break;
 
             case '{':
-                token.val.push_back(ch);
-                ch = fgetc(fp);
                 token.type = TokenType::LBRACE;
                 break;
 
             case '}':
-                token.val.push_back(ch);
-                ch = fgetc(fp);
                 token.type = TokenType::RBRACE;
                 break;
 
             case '0': // TODO: ERROR
-                token.val.push_back(ch);
-                ch = fgetc(fp);
-                if (isDigit(ch) || isAlpha(ch))
+                token.val.assign(first, cur);
+                if (isDigit(*cur) || isAlpha(*cur))
                 {
                     token.type = TokenType::INTERR;
-                    do
-                    {
-                        ch = fgetc(fp);
-
-                    } while (isDigit(ch) || isAlpha(ch));
+                    while (isDigit(*++cur) || isAlpha(*cur));
                 }
                 else
                 {
                     token.type = TokenType::INTCON;
                 }
-                break;
+                return;
 
             default:
-                if (isDigit(ch))
+                if (isDigit(*first))
                 {
-                    do
+                    while (isDigit(*cur))
                     {
-                        token.val.push_back(ch);
-                        ch = fgetc(fp);
-
-                    } while (isDigit(ch));
+                        ++cur;
+                    }
+                    token.val.assign(first, cur);
 
-                    if (isAlpha(ch))
+                    if (isAlpha(*cur))
                     {
                         token.type = TokenType::INTERR;
-                        do
-                        {
-                            ch = fgetc(fp);
-
-                        } while (isDigit(ch) || isAlpha(ch));
+                        while (isDigit(*++cur) || isAlpha(*cur));
                     }
                     else
                     {
                         token.type = TokenType::INTCON;
                     }
+                    return;
                 }
-                else if (isAlpha(ch))
+                else if (isAlpha(*first))
                 {
-                    do
+                    unsigned hash = fnvStep(FNV_OFFSET, *first);
+                    while (isAlpha(*cur) || isDigit(*cur))
+                    {
+                        hash = fnvStep(hash, *cur);
+                        ++cur;
+                    }
+                    token.val.assign(first, cur);
+                    token.type = lexKeywords.find(first, static_cast<int>(cur - first), hash);
+                    if (token.type == TokenType::NONE)
                     {
-                        token.val.push_back(ch);
-                        ch = fgetc(fp);
-                    } while (isAlpha(ch) || isDigit(ch));
-                    token.type = lexTrie.get(token.val.c_str());
+                        token.type = TokenType::IDENFR;
+                    }
+                    token.hash = hash;
+                    return;
                 }
                 else
                 {
-                    // TODO: ERROR
+                    --cur; // TODO: ERROR
+                    return;
                 }
-                break;
             }
 
+            token.val.assign(first, cur);
             return;
         }
     }
@@ -26,7 +26,10 @@
 #include <cstdio>
 #include <string>
 
-#include "regexp"
+#include "dfa"
+#include "hashtable.h"
+#include "perfecthash"
+#include "source.h"
 
 namespace scc
 {
@@ -37,16 +40,113 @@ namespace scc
 
     extern char typeName[static_cast<unsigned>(TokenType::END)][TYPE_NAME_MAX];
 
-    extern Trie<TokenType> lexTrie;
+    extern DFA<TokenType> lexDFA;
+
+    // tables generated from sc.lang at build time, see lexdfa.cpp
+
+    extern const int LANG_CLASS_CNT;
+
+    extern const int LANG_STATE_CNT;
+
+    extern const unsigned char LANG_CLASS_OF[256];
+
+    extern const int LANG_NEXT[];
+
+    extern const TokenType LANG_DATA[];
+
+    extern const int LANG_KEYWORD_SIZE;
+
+    extern const unsigned LANG_KEYWORD_MULT;
+
+    extern const TokenType LANG_KEYWORD_DATA[];
+
+    extern const int LANG_KEYWORD_OFFSET[];
+
+    extern const char LANG_KEYWORD_WORDS[];
+
+    /**
+     * Keywords among identifiers in lexDFA, for DFALexer
+     */
+    extern PerfectHash<TokenType> lexKeywords;
+
+    /**
+     * View of a token value in the source buffer, valid until the lexer is closed
+     */
+    class TokenVal
+    {
+    private:
+
+        const char* first;
+
+        int len;
+
+    public:
+
+        TokenVal() : first(nullptr), len(0)
+        {
+        }
+
+        void assign(const char* first, const char* last)
+        {
+            this->first = first;
+            len = static_cast<int>(last - first);
+        }
+
+        void clear()
+        {
+            len = 0;
+        }
+
+        const char* data() const
+        {
+            return first;
+        }
+
+        int size() const
+        {
+            return len;
+        }
+
+        char operator[](int i) const
+        {
+            return first[i];
+        }
+
+        /**
+         * Materialize the value where ownership is needed
+         */
+        std::string str() const
+        {
+            return std::string(first, len);
+        }
+    };
 
     struct Token
     {
         int row;
         TokenType type = TokenType::NONE;
-        std::string val;
+        TokenVal val;
+
+        // fnvHash of val if type == TokenType::IDENFR, for symbol tables
+        unsigned hash = 0;
     };
 
-    void readLang(const char* fileName, bool buildTrie);
+    /**
+     * @return whether all regexps are valid
+     */
+    bool readLang(const char* fileName, bool buildDFA);
+
+    /**
+     * Use the tables generated from sc.lang at build time instead of reading a lang file
+     */
+    void loadLang();
+
+    /**
+     * Build lexKeywords from lexDFA built or loaded at run time
+     *
+     * @return whether the keywords are finite and hashed
+     */
+    bool buildKeywords();
 
     /**
      * Abstract base class of lexers used for lexical analysis
@@ -55,15 +155,17 @@ namespace scc
     {
     protected:
 
-        // File Pointer
-        FILE *fp;
+        SourceBuffer source;
+
+        // cursor & end of source
+        const char* cur;
+
+        const char* end;
 
         const char* fileName;
 
         int row;
 
-        char ch;
-
     public:
 
         Lexer();
@@ -96,7 +198,7 @@ namespace scc
     };
 
     /**
-     * Lexical analyzer with Trie
+     * Lexical analyzer with the minimized DFA generated from the lang file
      */
     class TrieLexer : public Lexer
     {
@@ -19,7 +19,12 @@
 */
 
 #include "lexer.h"
+#include "trace.h"
+#include "langcache.h"
 #include "parser.h"
+#include "server.h"
+#include "objcache.h"
+#include "timereport.h"
 
 #include "define.h"
 #include "config.h"
@@ -31,22 +36,28 @@
 #include <cstring>
 #include <clocale>
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
 #if defined(CG) && CG == 4
 void runBin(const char* fileName);
 #endif
 
-void lexerOnly(const Config& config)
+/**
+ * @param report: where the time of lexing is added if not null
+ *
+ * @exception throw FileError if fail
+ */
+void lexerOnly(const Config& config, scc::TimeReport* report = nullptr)
 {
+    scc::Clock start = scc::Clock::now();
+    long long tokenCnt = 0;
     scc::TrieLexer lexer;
-    try
-    {
-        lexer.open(config.inputFileName);
-    }
-    catch(const FileError& e)
-    {
-        e.print(stderr);
-        exit(1);
-    }
+    lexer.open(config.inputFileName);
 
     scc::Token token;
     if (config.lexFileName == nullptr)
@@ -56,126 +67,383 @@ void lexerOnly(const Config& config)
             token.type = scc::TokenType::NONE;
             token.val.clear();
             lexer.nextToken(token);
+            tokenCnt++;
         }
         while (token.type != scc::TokenType::FEOF);
     }
     else
     {
         // Open lexical analysis result file
-        FILE *fp;
-        if (strcmp(config.lexFileName, "-") == 0)
-        {
-            fp = stdout;
-        }
-        else
-        {
-            fp = fopen(config.lexFileName, "w");
-        }
-        if (fp == nullptr)
-        {
-            throw FileError(config.lexFileName, "lexical analysis result");
-        }
+        scc::TraceWriter writer;
+        writer.open(config.lexFileName, "lexical analysis result");
 
         // Analyze
         lexer.nextToken(token);
         while (token.type != scc::TokenType::FEOF)
         {
-            fprintf(fp, "%s %s\n", scc::typeName[static_cast<unsigned>(token.type)], token.val.c_str());
+            writer.writeToken(token);
             token.type = scc::TokenType::NONE;
             token.val.clear();
             lexer.nextToken(token);
+            tokenCnt++;
         }
 
-        fclose(fp);
+        writer.close();
     }
     lexer.close();
+
+    if (report != nullptr)
+    {
+        report->add(scc::TimeReport::LEX, scc::Clock::since(start));
+        report->count(scc::TimeReport::FILES, 1);
+        report->count(scc::TimeReport::TOKENS, tokenCnt);
+    }
 }
 
-bool compile(const Config& config)
+/**
+ * @param errorFp: where errors are printed instead of config.errFileName if not null
+ * @param report: where the time of each phase is added if not null
+ * @return whether no error is found
+ *
+ * @exception throw FileError if fail
+ */
+bool compile(const Config& config, FILE* errorFp = nullptr, scc::TimeReport* report = nullptr);
+
+/**
+ * Take the object and diagnostics from the cache, or compile and save them into it
+ *
+ * @param errorFp: where errors are printed instead of config.errFileName if not null
+ * @return whether no error is found
+ *
+ * @exception throw FileError if fail
+ */
+bool compileCached(const Config& config, scc::ObjectCache& cache, FILE* errorFp)
 {
-    scc::Lexer* lexer = new scc::TrieLexer;
-    lexer->open(config.inputFileName);
+    FILE* fp = errorFp;
+    if (fp == nullptr)
+    {
+        fp = strcmp(config.errFileName, "-") == 0 ? stderr : fopen(config.errFileName, "w");
+        if (fp == nullptr)
+        {
+            throw FileError(config.errFileName, "error");
+        }
+    }
 
-    scc::Parser* parser = new scc::RecursiveParser(config.optimize);
-    parser->setLexer(lexer);
+    bool success;
+    std::string diagnostics;
+    try
+    {
+        if (!cache.fetch(success, diagnostics, config.objectFileName))
+        {
+            // the diagnostics are kept for the entry
+            Config job(config);
+            job.cache = false;
+            FILE* tmp = tmpfile();
+            if (tmp == nullptr)
+            {
+                success = compile(job, fp);
+            }
+            else
+            {
+                try
+                {
+                    success = compile(job, tmp);
+                }
+                catch (const FileError& e)
+                {
+                    fclose(tmp);
+                    throw;
+                }
+                rewind(tmp);
+                char buffer[BUFSIZ];
+                size_t k;
+                while ((k = fread(buffer, 1, BUFSIZ, tmp)) > 0)
+                {
+                    diagnostics.append(buffer, k);
+                }
+                fclose(tmp);
+                cache.store(success, diagnostics, config.objectFileName);
+            }
+        }
+        fwrite(diagnostics.data(), 1, diagnostics.size(), fp);
+    }
+    catch (const FileError& e)
+    {
+        if (fp != errorFp && fp != stderr)
+        {
+            fclose(fp);
+        }
+        throw;
+    }
+    if (fp != errorFp && fp != stderr)
+    {
+        fclose(fp);
+    }
+    return success;
+}
 
-    parser->open(config.lexFileName, config.parserFileName, config.errFileName);
+bool compile(const Config& config, FILE* errorFp, scc::TimeReport* report)
+{
+    // traces, statistics, time reports and stdin are not cached
+    scc::ObjectCache cache;
+    if (config.cache && config.objectFileName != nullptr && strcmp(config.objectFileName, "-") != 0
+            && config.lexFileName == nullptr && config.parserFileName == nullptr && !config.verbose
+            && report == nullptr
+            && cache.open(config.inputFileName, config.optimize, config.bin, config.cacheSize))
+    {
+        return compileCached(config, cache, errorFp);
+    }
 
-    bool success = parser->parse();
+    // reading the source is counted as lexing
+    scc::Clock start = scc::Clock::now();
+    scc::TrieLexer lexer;
+    lexer.open(config.inputFileName);
+    if (report != nullptr)
+    {
+        report->add(scc::TimeReport::LEX, scc::Clock::since(start));
+        report->count(scc::TimeReport::FILES, 1);
+    }
+
+    scc::RecursiveParser parser(config.optimize);
+    parser.setReport(report, config.inputFileName);
+    parser.setLexer(&lexer, config.threadedLex);
+
+    if (errorFp == nullptr)
+    {
+        parser.open(config.lexFileName, config.parserFileName, config.errFileName);
+    }
+    else
+    {
+        parser.setErrorFile(errorFp);
+        parser.open(config.lexFileName, config.parserFileName, nullptr);
+    }
+
+    bool success = parser.parse();
 
     if (success && config.objectFileName != nullptr)
     {
+        start = scc::Clock::now();
+        parser.link(config.verbose);
+        if (report != nullptr)
+        {
+            report->add(scc::TimeReport::LINK, scc::Clock::since(start));
+        }
+
+        start = scc::Clock::now();
         if (config.bin)
         {
-            parser->writeBin(config.objectFileName);
+            parser.writeBin(config.objectFileName);
         }
         else
         {
-            parser->writeText(config.objectFileName);
+            parser.writeText(config.objectFileName);
+        }
+        if (report != nullptr)
+        {
+            report->add(scc::TimeReport::EMIT, scc::Clock::since(start));
         }
     }
 
-    parser->close();
-    delete parser;
-    lexer->close();
-    delete lexer;
+    parser.close();
+    lexer.close();
 
     return success;
 }
 
-int main(int argc, char **argv)
+/**
+ * Compile each of config.inputFileNames on config.jobs threads, sharing the lexer tables.
+ * The diagnostics of each file are kept until those of the files before it are printed
+ *
+ * @param report: where the time of each phase of each file is added if not null
+ * @return whether no error is found in any file
+ */
+bool compileAll(const Config& config, scc::TimeReport* report)
 {
-    setlocale(LC_ALL, "zh_CN.UTF-8"); // TODO: Windows
+    Config base(config);
+    base.inputFileNames.clear();
 
-    // Set options according to arguments
-    Config config;
-    try
+    int n = config.inputFileNames.size();
+    int jobs = config.jobs > 0 ? config.jobs : std::max(1u, std::thread::hardware_concurrency());
+    jobs = std::min(jobs, n);
+
+    std::vector<std::string> diagnostics(n);
+    std::vector<char> success(n, false), done(n, false);
+    std::atomic<int> next(0);
+    std::mutex mutex;
+    int printed = 0;
+
+    auto work = [&]()
     {
-        config.set(argc, argv);
+        int i;
+        while ((i = next++) < n)
+        {
+            Config job(base);
+            job.inputFileName = config.inputFileNames[i];
+            std::string lexFileName, parserFileName, objectFileName;
+            if (job.lexFileName != nullptr)
+            {
+                lexFileName = Config::expand(job.lexFileName, job.inputFileName);
+                job.lexFileName = lexFileName.c_str();
+            }
+            if (job.parserFileName != nullptr)
+            {
+                parserFileName = Config::expand(job.parserFileName, job.inputFileName);
+                job.parserFileName = parserFileName.c_str();
+            }
+            if (job.objectFileName != nullptr)
+            {
+                objectFileName = Config::expand(job.objectFileName, job.inputFileName);
+                job.objectFileName = objectFileName.c_str();
+            }
+
+            FILE* fp = tmpfile();
+            FILE* errorFp = fp != nullptr ? fp : stderr;
+            try
+            {
+                if (job.lexOnly)
+                {
+                    lexerOnly(job, report);
+                    success[i] = true;
+                }
+                else
+                {
+                    success[i] = compile(job, errorFp, report);
+                }
+            }
+            catch (const FileError& e)
+            {
+                e.print(errorFp);
+            }
+            if (fp != nullptr)
+            {
+                rewind(fp);
+                char buffer[BUFSIZ];
+                size_t k;
+                while ((k = fread(buffer, 1, BUFSIZ, fp)) > 0)
+                {
+                    diagnostics[i].append(buffer, k);
+                }
+                fclose(fp);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            done[i] = true;
+            for (; printed < n && done[printed]; printed++)
+            {
+                fputs(diagnostics[printed].c_str(), stderr);
+                std::string().swap(diagnostics[printed]);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < jobs; i++)
+    {
+        threads.emplace_back(work);
     }
-    catch (const InvalidArgumentError& e)
+    work();
+    for (auto& it : threads)
     {
-        e.print(stderr);
-        exit(1); // TODO
+        it.join();
     }
 
+    return std::all_of(success.begin(), success.end(), [](char it) { return it != 0; });
+}
+
+/**
+ * Print the time report into stderr and / or the JSON file as configured
+ *
+ * @exception throw FileError if fail
+ */
+void printReport(const Config& config, scc::TimeReport& report)
+{
+    if (config.timeReport)
+    {
+        report.print(stderr);
+    }
+    if (config.timeReportFileName != nullptr)
+    {
+        FILE* fp = strcmp(config.timeReportFileName, "-") == 0 ? stdout : fopen(config.timeReportFileName, "w");
+        if (fp == nullptr)
+        {
+            throw FileError(config.timeReportFileName, "time report");
+        }
+        report.printJson(fp);
+        if (fp != stdout)
+        {
+            fclose(fp);
+        }
+    }
+}
+
+/**
+ * @return exit status
+ */
+int run(const Config& config)
+{
+    // the total time starts here, and phases are added only if a report is asked for
+    scc::TimeReport timeReport;
+    scc::TimeReport* report = config.timeReport || config.timeReportFileName != nullptr ? &timeReport : nullptr;
+
+    // the cache is mapped while compiling
+    scc::LangCache langCache;
     try
     {
-        scc::readLang(config.langFileName, true);
+        scc::Clock start = scc::Clock::now();
+        if (config.customLang)
+        {
+            if (!langCache.load(config.langFileName) && scc::readLang(config.langFileName, true))
+            {
+                langCache.save();
+            }
+        }
+        else
+        {
+            scc::loadLang();
+        }
+        timeReport.add(scc::TimeReport::READ_LANG, scc::Clock::since(start));
     }
     catch (const FileError& e)
     {
         e.print(stderr);
-        exit(1);
+        return 1;
     }
 
-    if (config.lexOnly)
+    int status = 0;
+    if (!config.inputFileNames.empty())
+    {
+        if (!compileAll(config, report))
+        {
+            status = 1;
+        }
+    }
+    else if (config.lexOnly)
     {
         try
         {
-            lexerOnly(config);
+            lexerOnly(config, report);
         }
         catch (const FileError& e)
         {
             e.print(stderr);
-            exit(1); // TODO
+            return 1; // TODO
         }
     }
     else
     {
         try
         {
-            if (!compile(config))
+            if (!compile(config, nullptr, report))
             {
 #ifndef CG
-                exit(1);
+                status = 1;
 #endif
             }
         }
         catch (const FileError& e)
         {
             e.print(stderr);
-            exit(1); // TODO
+            return 1; // TODO
         }
         // TODO
 
@@ -184,5 +452,105 @@ int main(int argc, char **argv)
 #endif
 
     }
-    return 0;
+
+    if (report != nullptr)
+    {
+        try
+        {
+            printReport(config, timeReport);
+        }
+        catch (const FileError& e)
+        {
+            e.print(stderr);
+            return 1;
+        }
+    }
+    return status;
+}
+
+#ifndef CG
+
+/**
+ * Run a request of the server
+ *
+ * @return exit status
+ */
+int serveRequest(int argc, char **argv)
+{
+    Config config;
+    try
+    {
+        config.set(argc, argv);
+    }
+    catch (const InvalidArgumentError& e)
+    {
+        e.print(stderr);
+        return 1;
+    }
+    catch (const FileError& e)
+    {
+        e.print(stderr);
+        return 1;
+    }
+    return run(config);
+}
+
+#endif
+
+int main(int argc, char **argv)
+{
+    setlocale(LC_ALL, "zh_CN.UTF-8"); // TODO: Windows
+
+#ifndef CG
+    // arguments as given, as set changes them
+    std::vector<std::string> args(argv, argv + argc);
+#endif
+
+    // Set options according to arguments
+    Config config;
+    try
+    {
+        config.set(argc, argv);
+    }
+    catch (const InvalidArgumentError& e)
+    {
+        e.print(stderr);
+        exit(1); // TODO
+    }
+    catch (const FileError& e)
+    {
+        e.print(stderr);
+        exit(1);
+    }
+
+#ifndef CG
+    if (config.cacheStats)
+    {
+        scc::ObjectCache::printStats(stdout, config.cacheSize);
+        return 0;
+    }
+    if (config.serverName != nullptr)
+    {
+        // warm up what every request would do, for the forked processes to inherit
+        scc::loadLang();
+        scc::RecursiveParser parser(config.optimize);
+        return scc::serve(config.serverName, serveRequest) ? 0 : 1;
+    }
+    if (config.connectName != nullptr)
+    {
+        // arguments are checked here, so the server only reports errors in compiling
+        std::vector<char*> argvGiven;
+        for (auto& it : args)
+        {
+            argvGiven.push_back(&it[0]);
+        }
+        int status;
+        if (scc::request(config.connectName, argc, argvGiven.data(), status))
+        {
+            return status;
+        }
+    }
+#endif
+
+    return run(config);
 }
@@ -0,0 +1,384 @@
+/*
+    Cache of compiled objects of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "objcache.h"
+#include "langcache.h"
+#include "lexer.h"
+#include "source.h"
+#include "config.h"
+#include "define.h"
+
+#include "../../common/src/exception.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#ifndef WINDOWS
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <utime.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#endif
+
+namespace scc
+{
+#ifndef WINDOWS
+
+    struct Stats
+    {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t size;
+    };
+
+    struct Entry
+    {
+        timespec time;
+        uint64_t size;
+        std::string name;
+    };
+
+    /**
+     * @return whether the name is of an entry, 16 hex digits
+     */
+    static bool isEntry(const char* name)
+    {
+        int i = 0;
+        for (; name[i] != '\0'; i++)
+        {
+            if (!isxdigit(static_cast<unsigned char>(name[i])))
+            {
+                return false;
+            }
+        }
+        return i == 16;
+    }
+
+    static std::vector<Entry> listEntries(const std::string& dir)
+    {
+        std::vector<Entry> entries;
+        DIR* d = opendir(dir.c_str());
+        if (d == nullptr)
+        {
+            return entries;
+        }
+        dirent* it;
+        while ((it = readdir(d)) != nullptr)
+        {
+            struct stat st;
+            if (isEntry(it->d_name) && stat((dir + '/' + it->d_name).c_str(), &st) == 0
+                    && S_ISREG(st.st_mode))
+            {
+                entries.push_back({st.st_mtim, static_cast<uint64_t>(st.st_size), it->d_name});
+            }
+        }
+        closedir(d);
+        return entries;
+    }
+
+#endif
+
+    // class ObjectCache
+
+    const char ObjectCache::MAGIC[8] = {'S', 'C', 'C', 'O', 'B', 'J', '\0', '\0'};
+
+    const uint64_t ObjectCache::DEFAULT_LIMIT;
+
+    ObjectCache::ObjectCache() : hash(0), limit(DEFAULT_LIMIT)
+    {
+    }
+
+    bool ObjectCache::open(const char* inputFileName, bool optimize, bool bin, uint64_t limit)
+    {
+        dir.clear();
+        path.clear();
+        source.close();
+        this->limit = limit;
+#ifndef WINDOWS
+        std::string base = cacheDir();
+        if (base.empty() || strcmp(inputFileName, "-") == 0)
+        {
+            return false;
+        }
+
+        // FNV-1a of the compiler, the lexer tables, the flags, the name and the source, in order
+        hash = FNV_BASIS;
+        fnv(hash, Config::VERSION, strlen(Config::VERSION) + 1);
+        struct stat st;
+        if (stat("/proc/self/exe", &st) == 0)
+        {
+            // a rebuilt compiler may give other objects with the same version
+            uint64_t exe[] = {static_cast<uint64_t>(st.st_size), static_cast<uint64_t>(st.st_mtime),
+                    static_cast<uint64_t>(st.st_ino)};
+            fnv(hash, exe, sizeof(exe));
+        }
+        int n = lexDFA.size(), m = lexDFA.classCnt;
+        fnv(hash, &n, sizeof(n));
+        fnv(hash, &m, sizeof(m));
+        fnv(hash, lexDFA.classOf, 256);
+        fnv(hash, lexDFA.next, sizeof(int) * n * m);
+        fnv(hash, lexDFA.data, sizeof(TokenType) * n);
+        fnv(hash, typeName, sizeof(typeName));
+        char flags[] = {optimize, bin};
+        fnv(hash, flags, sizeof(flags));
+        // the diagnostics name the source as given
+        fnv(hash, inputFileName, strlen(inputFileName) + 1);
+
+        try
+        {
+            source.open(inputFileName);
+        }
+        catch (const FileError& e)
+        {
+            return false;
+        }
+        fnv(hash, source.begin(), source.end() - source.begin());
+
+        char name[32];
+        snprintf(name, sizeof(name), "/%016llx", static_cast<unsigned long long>(hash));
+        dir = base + "/obj";
+        path = dir + name;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    bool ObjectCache::fetch(bool& success, std::string& diagnostics, const char* objectFileName)
+    {
+        if (path.empty())
+        {
+            return false;
+        }
+
+        SourceBuffer buffer;
+        bool found = true;
+        try
+        {
+            buffer.open(path.c_str());
+        }
+        catch (const FileError& e)
+        {
+            found = false;
+        }
+
+        Header header;
+        const char* p = buffer.begin();
+        size_t size = buffer.end() - p;
+        uint64_t sourceSize = source.end() - source.begin();
+        if (found)
+        {
+            memcpy(&header, p, std::min(size, sizeof(Header)));
+            found = size >= sizeof(Header) && memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0
+                    && header.version == VERSION && header.hash == hash && header.sourceSize == sourceSize
+                    && header.diagnosticSize <= size && header.objectSize <= size
+                    && size == sizeof(Header) + sourceSize + header.diagnosticSize + header.objectSize;
+            // a colliding hash of another source is a miss
+            found = found && memcmp(p + sizeof(Header), source.begin(), sourceSize) == 0;
+        }
+        if (!found)
+        {
+            count(0, 1, 0);
+            return false;
+        }
+
+        p += sizeof(Header) + sourceSize;
+        success = header.success != 0;
+        diagnostics.assign(p, header.diagnosticSize);
+        p += header.diagnosticSize;
+        if (success)
+        {
+            FILE* fp = fopen(objectFileName, "wb");
+            if (fp == nullptr)
+            {
+                throw FileError(objectFileName, "object");
+            }
+            bool ok = fwrite(p, 1, header.objectSize, fp) == header.objectSize;
+            if (fclose(fp) != 0 || !ok)
+            {
+                throw FileError(objectFileName, "object");
+            }
+        }
+
+#ifndef WINDOWS
+        // the time of last use, for eviction
+        utime(path.c_str(), nullptr);
+#endif
+        count(1, 0, 0);
+        return true;
+    }
+
+    void ObjectCache::store(bool success, const std::string& diagnostics, const char* objectFileName) const
+    {
+#ifndef WINDOWS
+        if (path.empty())
+        {
+            return;
+        }
+
+        SourceBuffer object;
+        if (success)
+        {
+            try
+            {
+                object.open(objectFileName);
+            }
+            catch (const FileError& e)
+            {
+                return;
+            }
+        }
+
+        makeDirs(dir);
+
+        std::string tmpPath;
+        FILE* fp = createFile(path, tmpPath);
+        if (fp == nullptr)
+        {
+            return;
+        }
+
+        Header header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.success = success;
+        header.hash = hash;
+        header.sourceSize = source.end() - source.begin();
+        header.diagnosticSize = diagnostics.size();
+        header.objectSize = success ? object.end() - object.begin() : 0;
+
+        bool ok = fwrite(&header, sizeof(header), 1, fp) == 1
+                && fwrite(source.begin(), 1, header.sourceSize, fp) == header.sourceSize
+                && fwrite(diagnostics.data(), 1, header.diagnosticSize, fp) == header.diagnosticSize
+                && fwrite(object.begin(), 1, header.objectSize, fp) == header.objectSize;
+        if (!commitFile(fp, tmpPath, path, ok))
+        {
+            return;
+        }
+        count(0, 0, sizeof(header) + header.sourceSize + header.diagnosticSize + header.objectSize);
+#endif
+    }
+
+    void ObjectCache::count(uint64_t hits, uint64_t misses, uint64_t size) const
+    {
+#ifndef WINDOWS
+        std::string statsPath = dir + "/stats";
+        int fd = ::open(statsPath.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0)
+        {
+            makeDirs(dir);
+            if ((fd = ::open(statsPath.c_str(), O_RDWR | O_CREAT, 0644)) < 0)
+            {
+                return;
+            }
+        }
+        flock(fd, LOCK_EX);
+
+        Stats stats;
+        if (pread(fd, &stats, sizeof(stats), 0) != sizeof(stats))
+        {
+            memset(&stats, 0, sizeof(stats));
+        }
+        stats.hits += hits;
+        stats.misses += misses;
+        stats.size += size;
+
+        // the size counted may drift with entries replaced or removed by others, so sum it again
+        if (stats.size > limit)
+        {
+            std::vector<Entry> entries = listEntries(dir);
+            std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b)
+            {
+                return a.time.tv_sec < b.time.tv_sec
+                        || (a.time.tv_sec == b.time.tv_sec && a.time.tv_nsec < b.time.tv_nsec);
+            });
+            stats.size = 0;
+            for (const auto& it : entries)
+            {
+                stats.size += it.size;
+            }
+            // down to 3/4 of limit, so that not every store evicts
+            for (auto it = entries.begin(); it != entries.end() && stats.size > limit / 4 * 3; ++it)
+            {
+                if (remove((dir + '/' + it->name).c_str()) == 0)
+                {
+                    stats.size -= it->size;
+                }
+            }
+        }
+
+        pwrite(fd, &stats, sizeof(stats), 0);
+        flock(fd, LOCK_UN);
+        close(fd);
+#endif
+    }
+
+    void ObjectCache::printStats(FILE* fp, uint64_t limit)
+    {
+#ifndef WINDOWS
+        std::string dir = cacheDir();
+        if (dir.empty())
+        {
+            fprintf(fp, "no cache directory\n");
+            return;
+        }
+        dir += "/obj";
+
+        Stats stats;
+        memset(&stats, 0, sizeof(stats));
+        int fd = ::open((dir + "/stats").c_str(), O_RDONLY);
+        if (fd >= 0)
+        {
+            flock(fd, LOCK_SH);
+            if (pread(fd, &stats, sizeof(stats), 0) != sizeof(stats))
+            {
+                memset(&stats, 0, sizeof(stats));
+            }
+            flock(fd, LOCK_UN);
+            close(fd);
+        }
+
+        std::vector<Entry> entries = listEntries(dir);
+        uint64_t size = 0;
+        for (const auto& it : entries)
+        {
+            size += it.size;
+        }
+        uint64_t total = stats.hits + stats.misses;
+
+        fprintf(fp, "cache directory: %s\n", dir.c_str());
+        fprintf(fp, "entries:         %zu\n", entries.size());
+        fprintf(fp, "size:            %.1f / %.1f MiB\n", size / 1048576.0, limit / 1048576.0);
+        fprintf(fp, "hits:            %llu\n", static_cast<unsigned long long>(stats.hits));
+        fprintf(fp, "misses:          %llu\n", static_cast<unsigned long long>(stats.misses));
+        fprintf(fp, "hit rate:        %.1f%%\n", total != 0 ? 100.0 * stats.hits / total : 0.0);
+#else
+        fprintf(fp, "no cache directory\n");
+#endif
+    }
+}
@@ -0,0 +1,122 @@
+/*
+    Cache of compiled objects of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _SCC_OBJCACHE_H_
+#define _SCC_OBJCACHE_H_
+
+#include "source.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace scc
+{
+    /**
+     * Cache of objects and diagnostics under cacheDir()/obj, each entry named by the hash of the source
+     * and its name, the lexer tables, the flags deciding the object and the compiler itself. An entry keeps
+     * the source, so that a colliding hash is a miss. Once the entries grow beyond the limit, those used
+     * longest ago are evicted
+     */
+    class ObjectCache
+    {
+    protected:
+
+        static const char MAGIC[8];
+
+        /**
+         * Version of the format, an entry of another version is a miss
+         */
+        static const uint32_t VERSION = 2;
+
+        struct Header
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t success;
+            uint64_t hash;
+            uint64_t sourceSize;
+            uint64_t diagnosticSize;
+            uint64_t objectSize;
+        };
+
+        uint64_t hash;
+
+        SourceBuffer source;
+
+        uint64_t limit;
+
+        // empty if there is no cache directory or the source cannot be read
+        std::string dir;
+
+        std::string path;
+
+        /**
+         * Add to the counters in dir/stats, evicting entries if their size goes beyond limit
+         */
+        void count(uint64_t hits, uint64_t misses, uint64_t size) const;
+
+    public:
+
+        /**
+         * Default limit of the size of all entries
+         */
+        static const uint64_t DEFAULT_LIMIT = 256ull << 20;
+
+        ObjectCache();
+
+        /**
+         * Find the entry of the source, where the lexer tables must be loaded
+         *
+         * @param inputFileName: name of the source, hashed with its content
+         * @param optimize: whether the object is optimized
+         * @param bin: whether the object is binary
+         * @param limit: limit of the size of all entries in bytes
+         * @return whether the cache can be used
+         */
+        bool open(const char* inputFileName, bool optimize, bool bin, uint64_t limit);
+
+        /**
+         * Take the entry if any, copying the object to objectFileName
+         *
+         * @param success: whether the source was compiled without error
+         * @param diagnostics: errors and warnings printed when it was compiled
+         * @return whether the entry is found
+         *
+         * @exception throw FileError if the object cannot be written
+         */
+        bool fetch(bool& success, std::string& diagnostics, const char* objectFileName);
+
+        /**
+         * Save the result of compiling, with the object read from objectFileName if success,
+         * failing silently
+         */
+        void store(bool success, const std::string& diagnostics, const char* objectFileName) const;
+
+        /**
+         * Print the count and size of entries, and the hits and misses
+         */
+        static void printStats(FILE* fp, uint64_t limit);
+    };
+}
+
+#endif // _SCC_OBJCACHE_H_
@@ -0,0 +1,1020 @@
+/*
+    Optimizer of linked PCODE of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "optimizer.h"
+#include "parser.h"
+#include "define.h"
+
+#include "../../common/src/pcode.h"
+#include "../../interpreter/src/interpreter.h"
+
+#include <cstdio>
+#include <climits>
+#include <map>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+namespace scc
+{
+    static bool hasAddr(unsigned f)
+    {
+        return f == 0040 || f == 0042 || f == 0060 || f == 0070;
+    }
+
+    static bool isReturn(const sci::BPcode& code)
+    {
+        return code.f == 0100 && code.a == 0;
+    }
+
+    /**
+     * Invert a comparing OPR
+     *
+     * @return inverted a of OPR, or -1 if not a comparison
+     */
+    static int invertCompare(int a)
+    {
+        switch (a)
+        {
+        case 8:
+            return 11;
+
+        case 9:
+            return 10;
+
+        case 10:
+            return 9;
+
+        case 11:
+            return 8;
+
+        case 12:
+            return 13;
+
+        case 13:
+            return 12;
+
+        default:
+            return -1;
+        }
+    }
+
+    /**
+     * Calculate OPR a on constants, the same as sci does
+     *
+     * @return whether a is a foldable operation
+     */
+    static bool fold(int a, int x, int y, int& res)
+    {
+        switch (a)
+        {
+        case 2:
+            res = static_cast<int>(static_cast<unsigned>(x) + static_cast<unsigned>(y));
+            return true;
+
+        case 3:
+            res = static_cast<int>(static_cast<unsigned>(x) - static_cast<unsigned>(y));
+            return true;
+
+        case 4:
+            res = static_cast<int>(static_cast<unsigned>(x) * static_cast<unsigned>(y));
+            return true;
+
+        case 5:
+            if (y == 0 || (y == -1 && x == INT_MIN))
+            {
+                return false;
+            }
+            res = x / y;
+            return true;
+
+        case 8:
+            res = x < y;
+            return true;
+
+        case 9:
+            res = x <= y;
+            return true;
+
+        case 10:
+            res = x > y;
+            return true;
+
+        case 11:
+            res = x >= y;
+            return true;
+
+        case 12:
+            res = x == y;
+            return true;
+
+        case 13:
+            res = x != y;
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    static bool rewriteNothing(const sci::BPcode*, std::vector<sci::BPcode>&)
+    {
+        return true;
+    }
+
+    static bool rewriteFoldUnary(const sci::BPcode* codes, std::vector<sci::BPcode>& res)
+    {
+        int k = codes[0].a;
+        switch (codes[1].a)
+        {
+        case 1:
+            k = static_cast<int>(0u - static_cast<unsigned>(k));
+            break;
+
+        case 6:
+            k &= 1;
+            break;
+
+        case 7:
+            k = !k;
+            break;
+
+        default:
+            return false;
+        }
+        res.push_back({0010, k});
+        return true;
+    }
+
+    static bool rewriteFoldBinary(const sci::BPcode* codes, std::vector<sci::BPcode>& res)
+    {
+        int k;
+        if (!fold(codes[2].a, codes[0].a, codes[1].a, k))
+        {
+            return false;
+        }
+        res.push_back({0010, k});
+        return true;
+    }
+
+    static bool rewriteNotCompare(const sci::BPcode* codes, std::vector<sci::BPcode>& res)
+    {
+        int inv = invertCompare(codes[0].a);
+        if (inv < 0)
+        {
+            return false;
+        }
+        res.push_back({0100, inv});
+        return true;
+    }
+
+    static bool rewriteNotJump(const sci::BPcode* codes, std::vector<sci::BPcode>& res)
+    {
+        res.push_back({0070, codes[2].a});
+        res.push_back({0060, codes[1].a});
+        return true;
+    }
+
+    static bool rewriteLitJump(const sci::BPcode* codes, std::vector<sci::BPcode>& res)
+    {
+        if (codes[0].a == 0)
+        {
+            res.push_back({0060, codes[1].a});
+        }
+        return true;
+    }
+
+    static bool rewriteLoadPop(const sci::BPcode* codes, std::vector<sci::BPcode>& res)
+    {
+        if (codes[1].a < 1)
+        {
+            return false;
+        }
+        if (codes[1].a > 1)
+        {
+            res.push_back({0000, codes[1].a - 1});
+        }
+        return true;
+    }
+
+    static bool rewritePopPop(const sci::BPcode* codes, std::vector<sci::BPcode>& res)
+    {
+        res.push_back({0000, codes[0].a + codes[1].a});
+        return true;
+    }
+
+    static bool rewriteKeepPop(const sci::BPcode* codes, std::vector<sci::BPcode>& res)
+    {
+        if (codes[1].a < 1)
+        {
+            return false;
+        }
+        res.push_back({codes[0].f & ~2u, codes[0].a});
+        if (codes[1].a > 1)
+        {
+            res.push_back({0000, codes[1].a - 1});
+        }
+        return true;
+    }
+
+    static bool rewriteStoreLoad(const sci::BPcode* codes, std::vector<sci::BPcode>& res)
+    {
+        if (codes[0].a != codes[1].a)
+        {
+            return false;
+        }
+        res.push_back({codes[0].f | 2u, codes[0].a});
+        return true;
+    }
+
+    // struct Effect
+
+    Effect::Effect() :
+            begin(0), end(0), readGlobal(false), writeGlobal(false), io(false), recursive(false), loop(false)
+    {
+    }
+
+    bool Effect::pure() const
+    {
+        return !readGlobal && !writeGlobal && !io;
+    }
+
+    bool Effect::removable() const
+    {
+        return pure() && !recursive && !loop;
+    }
+
+    // struct GlobalUse
+
+    GlobalUse::GlobalUse() : array(false), outside(false)
+    {
+    }
+
+    // class Optimizer
+
+    const PeepholeRule Optimizer::PEEPHOLE_RULES[] =
+    {
+        {"pop-zero", 1, {{0000, 0}}, rewriteNothing},
+        {"add-zero", 2, {{0010, 0}, {0100, 2}}, rewriteNothing},
+        {"sub-zero", 2, {{0010, 0}, {0100, 3}}, rewriteNothing},
+        {"mul-one", 2, {{0010, 1}, {0100, 4}}, rewriteNothing},
+        {"div-one", 2, {{0010, 1}, {0100, 5}}, rewriteNothing},
+        {"neg-neg", 2, {{0100, 1}, {0100, 1}}, rewriteNothing},
+        {"fold-unary", 2, {{0010, PeepholeRule::ANY}, {0100, PeepholeRule::ANY}}, rewriteFoldUnary},
+        {"fold-binary", 3, {{0010, PeepholeRule::ANY}, {0010, PeepholeRule::ANY}, {0100, PeepholeRule::ANY}},
+                rewriteFoldBinary},
+        {"not-compare", 2, {{0100, PeepholeRule::ANY}, {0100, 7}}, rewriteNotCompare},
+        {"not-jump", 3, {{0100, 7}, {0070, PeepholeRule::ANY}, {0060, PeepholeRule::ANY}}, rewriteNotJump},
+        {"lit-jump", 2, {{0010, PeepholeRule::ANY}, {0070, PeepholeRule::ANY}}, rewriteLitJump},
+        {"lit-pop", 2, {{0010, PeepholeRule::ANY}, {0000, PeepholeRule::ANY}}, rewriteLoadPop},
+        {"lod-pop", 2, {{0020, PeepholeRule::ANY}, {0000, PeepholeRule::ANY}}, rewriteLoadPop},
+        {"lodg-pop", 2, {{0021, PeepholeRule::ANY}, {0000, PeepholeRule::ANY}}, rewriteLoadPop},
+        {"pop-pop", 2, {{0000, PeepholeRule::ANY}, {0000, PeepholeRule::ANY}}, rewritePopPop},
+        {"keep-pop", 2, {{0032, PeepholeRule::ANY}, {0000, PeepholeRule::ANY}}, rewriteKeepPop},
+        {"keepg-pop", 2, {{0033, PeepholeRule::ANY}, {0000, PeepholeRule::ANY}}, rewriteKeepPop},
+        {"sto-lod", 2, {{0030, PeepholeRule::ANY}, {0020, PeepholeRule::ANY}}, rewriteStoreLoad},
+        {"stog-lodg", 2, {{0031, PeepholeRule::ANY}, {0021, PeepholeRule::ANY}}, rewriteStoreLoad},
+    };
+
+    const int Optimizer::PEEPHOLE_RULE_CNT = sizeof(PEEPHOLE_RULES) / sizeof(PeepholeRule);
+
+    Optimizer::Optimizer(std::vector<sci::BPcode>& codes, std::vector<Fun>& funVector) :
+            codes(codes), funVector(funVector), ruleHits(PEEPHOLE_RULE_CNT)
+    {
+    }
+
+    Optimizer::~Optimizer() = default;
+
+    void Optimizer::markTargets()
+    {
+        int n = codes.size();
+        isTarget.assign(n + 1, false);
+        for (const auto& it : codes)
+        {
+            if (hasAddr(it.f))
+            {
+                isTarget[it.a] = true;
+            }
+        }
+        for (const auto& it : funVector)
+        {
+            isTarget[it.addr] = true;
+        }
+    }
+
+    int Optimizer::funAt(int addr) const
+    {
+        return addr >= 0 && addr < static_cast<int>(funIndex.size()) ? funIndex[addr] : -1;
+    }
+
+    void Optimizer::analyzeEffects()
+    {
+        int n = codes.size();
+        int m = funVector.size();
+
+        funIndex.assign(n + 1, -1);
+        std::vector<int> order(m);
+        for (int i = 0; i < m; i++)
+        {
+            funIndex[funVector[i].addr] = i;
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(), [this](int x, int y)
+        {
+            return funVector[x].addr < funVector[y].addr;
+        });
+
+        // direct effects, a function lasts until the next one begins
+        effects.assign(m, Effect());
+        for (int i = 0; i < m; i++)
+        {
+            Effect& effect = effects[order[i]];
+            effect.begin = funVector[order[i]].addr;
+            effect.end = i + 1 < m ? funVector[order[i + 1]].addr : n;
+            for (int j = effect.begin; j < effect.end; j++)
+            {
+                const sci::BPcode& code = codes[j];
+                switch (code.f)
+                {
+                case 0021:
+                case 0111:
+                    effect.readGlobal = true;
+                    break;
+
+                case 0031:
+                case 0033:
+                case 0121:
+                    effect.writeGlobal = true;
+                    break;
+
+                case 0040:
+                case 0042:
+                    if (funAt(code.a) >= 0)
+                    {
+                        effect.callees.push_back(funAt(code.a));
+                    }
+                    break;
+
+                case 0060:
+                case 0070:
+                    if (code.a <= j)
+                    {
+                        effect.loop = true;
+                    }
+                    break;
+
+                case 0100:
+                    if (code.a >= 14 && code.a <= 19)
+                    {
+                        effect.io = true;
+                    }
+                    break;
+
+                default:
+                    break;
+                }
+            }
+        }
+
+        // mark in vis the functions reachable from the callees of i
+        std::vector<bool> vis(m);
+        std::vector<int> stack;
+        auto reach = [&](int i)
+        {
+            vis.assign(m, false);
+            stack = effects[i].callees;
+            while (!stack.empty())
+            {
+                int x = stack.back();
+                stack.pop_back();
+                if (!vis[x])
+                {
+                    vis[x] = true;
+                    stack.insert(stack.end(), effects[x].callees.begin(), effects[x].callees.end());
+                }
+            }
+        };
+
+        // on a cycle if reachable from any of its callees
+        std::vector<bool> cyclic(m);
+        for (int i = 0; i < m; i++)
+        {
+            reach(i);
+            cyclic[i] = vis[i];
+        }
+
+        // then recursive if it reaches a cycle, whatever order the functions are declared in
+        for (int i = 0; i < m; i++)
+        {
+            reach(i);
+            Effect& effect = effects[i];
+            effect.recursive = cyclic[i];
+            for (int x = 0; x < m; x++)
+            {
+                if (vis[x])
+                {
+                    const Effect& callee = effects[x];
+                    effect.readGlobal |= callee.readGlobal;
+                    effect.writeGlobal |= callee.writeGlobal;
+                    effect.io |= callee.io;
+                    effect.loop |= callee.loop;
+                    effect.recursive |= cyclic[x];
+                }
+            }
+        }
+    }
+
+    void Optimizer::patch(std::vector<std::pair<int, std::vector<sci::BPcode> > >& patches)
+    {
+        int n = codes.size();
+        std::vector<int> newAddr(n + 1);
+        std::vector<sci::BPcode> res;
+        res.reserve(n);
+
+        auto it = patches.begin();
+        for (int i = 0; i < n; i++)
+        {
+            newAddr[i] = res.size();
+            if (it != patches.end() && it->first == i)
+            {
+                res.insert(res.end(), it->second.begin(), it->second.end());
+                ++it;
+            }
+            else
+            {
+                res.push_back(codes[i]);
+            }
+        }
+        newAddr[n] = res.size();
+
+        for (auto& it : res)
+        {
+            if (hasAddr(it.f))
+            {
+                it.a = newAddr[it.a];
+            }
+        }
+        for (auto& it : funVector)
+        {
+            it.addr = newAddr[it.addr];
+        }
+
+        codes.swap(res);
+        patches.clear();
+    }
+
+    bool Optimizer::threadJumps()
+    {
+        int n = codes.size();
+        std::vector<std::pair<int, std::vector<sci::BPcode> > > patches;
+        bool changed = false;
+
+        for (int i = 0; i < n; i++)
+        {
+            if (codes[i].f != 0060 && codes[i].f != 0070)
+            {
+                continue;
+            }
+
+            // follow JMP chains, bounded in case of a JMP cycle
+            int t = codes[i].a;
+            for (int steps = 0; steps < n && t < n && codes[t].f == 0060 && codes[t].a != t; steps++)
+            {
+                t = codes[t].a;
+            }
+            if (t != codes[i].a)
+            {
+                codes[i].a = t;
+                changed = true;
+            }
+
+            if (codes[i].f == 0060 && t < n && isReturn(codes[t]))
+            {
+                codes[i] = codes[t];
+                changed = true;
+            }
+            else if (t == i + 1)
+            {
+                // JMP to next is nothing, while JPC to next only pops condition
+                std::vector<sci::BPcode> seq;
+                if (codes[i].f == 0070)
+                {
+                    seq.push_back({0000, 1});
+                }
+                patches.emplace_back(i, std::move(seq));
+            }
+        }
+
+        if (!patches.empty())
+        {
+            patch(patches);
+            changed = true;
+        }
+        return changed;
+    }
+
+    bool Optimizer::invertBranches()
+    {
+        markTargets();
+
+        int n = codes.size();
+        std::vector<std::pair<int, std::vector<sci::BPcode> > > patches;
+
+        // OPR x; JPC L1; JMP L2; L1: -> OPR !x; JPC L2; L1:
+        for (int i = 1; i + 1 < n; i++)
+        {
+            if (codes[i].f == 0070 && codes[i].a == i + 2 && codes[i + 1].f == 0060
+                    && !isTarget[i] && !isTarget[i + 1] && codes[i - 1].f == 0100)
+            {
+                int inv = invertCompare(codes[i - 1].a);
+                if (codes[i - 1].a == 7)
+                {
+                    patches.emplace_back(i - 1, std::vector<sci::BPcode>());
+                }
+                else if (inv >= 0)
+                {
+                    codes[i - 1].a = inv;
+                }
+                else
+                {
+                    continue;
+                }
+                codes[i].a = codes[i + 1].a;
+                patches.emplace_back(i + 1, std::vector<sci::BPcode>());
+                i++;
+            }
+        }
+
+        if (patches.empty())
+        {
+            return false;
+        }
+        patch(patches);
+        return true;
+    }
+
+    bool Optimizer::rotateLoops()
+    {
+        markTargets();
+
+        int n = codes.size();
+        std::vector<std::pair<int, std::vector<sci::BPcode> > > patches;
+
+        // c: cond; JPC e; body; JMP c; e:  ->  c: cond; JPC e; b: body; cond'; JPC b; e:
+        for (int j = 0; j < n; j++)
+        {
+            if (codes[j].f != 0060 || codes[j].a >= j)
+            {
+                continue;
+            }
+            int c = codes[j].a;
+            int k = c;
+            while (k < j && k - c <= ROTATE_MAX && codes[k].f != 0060 && codes[k].f != 0070
+                    && !isReturn(codes[k]) && (k == c || !isTarget[k]))
+            {
+                k++;
+            }
+            if (k == c || k >= j || codes[k].f != 0070 || codes[k].a != j + 1 || isTarget[k])
+            {
+                continue;
+            }
+
+            std::vector<sci::BPcode> seq(codes.begin() + c, codes.begin() + k);
+            int inv = seq.back().f == 0100 ? invertCompare(seq.back().a) : -1;
+            if (inv >= 0)
+            {
+                seq.back().a = inv;
+            }
+            else if (seq.back().f == 0100 && seq.back().a == 7)
+            {
+                seq.pop_back();
+            }
+            else
+            {
+                seq.push_back({0100, 7});
+            }
+            seq.push_back({0070, k + 1});
+            patches.emplace_back(j, std::move(seq));
+        }
+
+        if (patches.empty())
+        {
+            return false;
+        }
+        patch(patches);
+        return true;
+    }
+
+    bool Optimizer::removeUnreachable()
+    {
+        markTargets();
+
+        int n = codes.size();
+        std::vector<std::pair<int, std::vector<sci::BPcode> > > patches;
+
+        bool dead = false;
+        for (int i = 1; i < n; i++)
+        {
+            if (isTarget[i])
+            {
+                dead = false;
+            }
+            if (dead)
+            {
+                patches.emplace_back(i, std::vector<sci::BPcode>());
+            }
+            else if (codes[i].f == 0060 || isReturn(codes[i]))
+            {
+                dead = true;
+            }
+        }
+
+        if (patches.empty())
+        {
+            return false;
+        }
+        patch(patches);
+        return true;
+    }
+
+    bool Optimizer::removeDeadCalls()
+    {
+        markTargets();
+        analyzeEffects();
+
+        int n = codes.size();
+        std::vector<std::pair<int, std::vector<sci::BPcode> > > patches;
+
+        // a call leaves its (modified) parameters on stack after returning,
+        // so a call whose result is popped can be dropped alone
+        for (int i = 1; i < n; i++)
+        {
+            int id = codes[i].f == 0040 || codes[i].f == 0042 ? funAt(codes[i].a) : -1;
+            if (id < 0 || !effects[id].removable())
+            {
+                continue;
+            }
+            int cnt = codes[i].f == 0042 ? 1 : funVector[id].paramTypes.size();
+            if (cnt == 0)
+            {
+                patches.emplace_back(i, std::vector<sci::BPcode>());
+            }
+            else if (i + 1 < n && codes[i + 1].f == 0000 && codes[i + 1].a >= cnt && !isTarget[i + 1])
+            {
+                patches.emplace_back(i, std::vector<sci::BPcode>());
+                if (codes[i].f == 0042)
+                {
+                    std::vector<sci::BPcode> seq;
+                    if (codes[i + 1].a > 1)
+                    {
+                        seq.push_back({0000, codes[i + 1].a - 1});
+                    }
+                    patches.emplace_back(i + 1, std::move(seq));
+                }
+                i++;
+            }
+        }
+
+        if (patches.empty())
+        {
+            return false;
+        }
+        patch(patches);
+        return true;
+    }
+
+    bool Optimizer::evalCalls()
+    {
+        markTargets();
+        analyzeEffects();
+
+        int n = codes.size();
+        std::vector<std::pair<int, std::vector<sci::BPcode> > > patches;
+        sci::BInterpreter interpreter;
+        interpreter.set(codes.data());
+        std::vector<int> params;
+        int res;
+
+        // LIT p1; ...; LIT pn; CAL f; POP n-1  ->  LIT f(p1, ..., pn)
+        for (int i = 1; i < n; i++)
+        {
+            int id = codes[i].f == 0040 || codes[i].f == 0042 ? funAt(codes[i].a) : -1;
+            if (id < 0 || !effects[id].pure() || isTarget[i] || funVector[id].returnType == VarType::VOID)
+            {
+                continue;
+            }
+            int cnt = codes[i].f == 0042 ? 0 : funVector[id].paramTypes.size();
+            int j = i - cnt;
+            if (j < 1 || (cnt > 1 && (i + 1 >= n || codes[i + 1].f != 0000 || codes[i + 1].a < cnt - 1
+                    || isTarget[i + 1])))
+            {
+                continue;
+            }
+            params.clear();
+            for (int k = j; k < i && codes[k].f == 0010 && (k == j || !isTarget[k]); k++)
+            {
+                params.push_back(codes[k].a);
+            }
+            if (static_cast<int>(params.size()) != cnt || !interpreter.call(codes[i].a, params, res, EVAL_STEPS))
+            {
+                continue;
+            }
+
+            for (int k = j; k < i; k++)
+            {
+                patches.emplace_back(k, std::vector<sci::BPcode>());
+            }
+            patches.emplace_back(i, std::vector<sci::BPcode>(1, {0010, res}));
+            if (cnt > 1)
+            {
+                std::vector<sci::BPcode> seq;
+                if (codes[i + 1].a > cnt - 1)
+                {
+                    seq.push_back({0000, codes[i + 1].a - cnt + 1});
+                }
+                patches.emplace_back(i + 1, std::move(seq));
+                i++;
+            }
+        }
+
+        if (patches.empty())
+        {
+            return false;
+        }
+        patch(patches);
+        return true;
+    }
+
+    bool Optimizer::peephole()
+    {
+        markTargets();
+
+        int n = codes.size();
+        std::vector<std::pair<int, std::vector<sci::BPcode> > > patches;
+        std::vector<sci::BPcode> res;
+
+        for (int i = 1; i < n; i++)
+        {
+            for (int r = 0; r < PEEPHOLE_RULE_CNT; r++)
+            {
+                const PeepholeRule& rule = PEEPHOLE_RULES[r];
+                int k = 0;
+                while (k < rule.len && i + k < n && codes[i + k].f == rule.pattern[k].f
+                        && (rule.pattern[k].a == PeepholeRule::ANY || codes[i + k].a == rule.pattern[k].a)
+                        && (k == 0 || !isTarget[i + k]))
+                {
+                    k++;
+                }
+                res.clear();
+                if (k < rule.len || !rule.rewrite(&codes[i], res))
+                {
+                    continue;
+                }
+
+                ruleHits[r]++;
+                patches.emplace_back(i, res);
+                for (k = 1; k < rule.len; k++)
+                {
+                    patches.emplace_back(i + k, std::vector<sci::BPcode>());
+                }
+                i += rule.len - 1;
+                break;
+            }
+        }
+
+        if (patches.empty())
+        {
+            return false;
+        }
+        patch(patches);
+        return true;
+    }
+
+    void Optimizer::analyzeGlobals(int mainId, std::map<int, GlobalUse>& uses)
+    {
+        int n = codes.size();
+        const Effect& effect = effects[mainId];
+        for (int i = 1; i < n; i++)
+        {
+            GlobalUse* use;
+            switch (codes[i].f)
+            {
+            case 0021:
+                use = &uses[codes[i].a];
+                use->reads.push_back(i);
+                break;
+
+            case 0031:
+            case 0033:
+                use = &uses[codes[i].a];
+                use->writes.push_back(i);
+                break;
+
+            case 0111:
+            case 0121:
+                use = &uses[codes[i].a];
+                use->array = true;
+                break;
+
+            default:
+                continue;
+            }
+            if (i < effect.begin || i >= effect.end)
+            {
+                use->outside = true;
+            }
+        }
+    }
+
+    bool Optimizer::constGlobals()
+    {
+        markTargets();
+        analyzeEffects();
+
+        int n = codes.size();
+        int mainId = funAt(codes[0].a);
+        if (mainId < 0)
+        {
+            return false;
+        }
+        std::map<int, GlobalUse> uses;
+        analyzeGlobals(mainId, uses);
+
+        // straight-line codes main begins with, which run once before anything else
+        const Effect& effect = effects[mainId];
+        int entryEnd = effect.begin;
+        while (entryEnd < effect.end && (entryEnd == effect.begin || !isTarget[entryEnd])
+                && codes[entryEnd].f != 0040 && codes[entryEnd].f != 0042 && codes[entryEnd].f != 0060
+                && codes[entryEnd].f != 0070 && !isReturn(codes[entryEnd]))
+        {
+            entryEnd++;
+        }
+        for (int i = 1; i < n; i++)
+        {
+            if ((codes[i].f == 0040 || codes[i].f == 0042) && codes[i].a == effect.begin)
+            {
+                return false;
+            }
+        }
+
+        std::map<int, std::vector<sci::BPcode> > replaces;
+        for (const auto& it : uses)
+        {
+            const GlobalUse& use = it.second;
+            if (use.array || use.reads.empty())
+            {
+                continue;
+            }
+
+            int k;
+            if (use.writes.empty())
+            {
+                k = 0;
+            }
+            else if (use.writes.size() == 1)
+            {
+                int s = use.writes.front();
+                if (s - 1 < effect.begin || s >= entryEnd || codes[s - 1].f != 0010 || isTarget[s]
+                        || std::any_of(use.reads.begin(), use.reads.end(), [&](int i)
+                        {
+                            return i >= effect.begin && i < s;
+                        }))
+                {
+                    continue;
+                }
+                k = codes[s - 1].a;
+                if (codes[s].f == 0031)
+                {
+                    replaces[s - 1];
+                }
+                replaces[s];
+            }
+            else
+            {
+                continue;
+            }
+
+            for (int i : use.reads)
+            {
+                replaces[i].push_back({0010, k});
+            }
+        }
+
+        if (replaces.empty())
+        {
+            return false;
+        }
+        std::vector<std::pair<int, std::vector<sci::BPcode> > > patches(replaces.begin(), replaces.end());
+        patch(patches);
+        return true;
+    }
+
+    bool Optimizer::localizeGlobals()
+    {
+        analyzeEffects();
+
+        int mainId = funAt(codes[0].a);
+        if (mainId < 0 || effects[mainId].recursive)
+        {
+            return false;
+        }
+        std::map<int, GlobalUse> uses;
+        analyzeGlobals(mainId, uses);
+
+        // locals of main are placed from offset 2 after saved sp and ip
+        const Effect& effect = effects[mainId];
+        bool hasInt = codes[effect.begin].f == 0050;
+        int size = hasInt ? codes[effect.begin].a : 0;
+        for (const auto& it : codes)
+        {
+            // the INT inserted must not be jumped to
+            if ((it.f == 0060 || it.f == 0070) && it.a == effect.begin)
+            {
+                return false;
+            }
+        }
+        std::vector<sci::BPcode> seq;
+        for (const auto& it : uses)
+        {
+            const GlobalUse& use = it.second;
+            if (use.array || use.outside)
+            {
+                continue;
+            }
+            int offset = 2 + size++;
+            for (int i : use.reads)
+            {
+                codes[i] = {0020, offset};
+            }
+            for (int i : use.writes)
+            {
+                codes[i] = {codes[i].f & ~1u, offset};
+            }
+            seq.push_back({0010, 0});
+            seq.push_back({0030, offset});
+        }
+
+        if (seq.empty())
+        {
+            return false;
+        }
+        seq.insert(seq.begin(), {0050, size});
+        if (!hasInt)
+        {
+            seq.push_back(codes[effect.begin]);
+        }
+        std::vector<std::pair<int, std::vector<sci::BPcode> > > patches;
+        patches.emplace_back(effect.begin, std::move(seq));
+        patch(patches);
+        return true;
+    }
+
+    void Optimizer::optimize()
+    {
+        bool changed = true;
+        while (changed)
+        {
+            changed = constGlobals();
+            changed |= localizeGlobals();
+            changed |= threadJumps();
+            changed |= removeUnreachable();
+            changed |= invertBranches();
+            changed |= rotateLoops();
+            changed |= removeDeadCalls();
+            changed |= evalCalls();
+            changed |= peephole();
+        }
+        analyzeEffects();
+    }
+
+    const std::vector<Effect>& Optimizer::getEffects() const
+    {
+        return effects;
+    }
+
+    void Optimizer::printStats(FILE* fp) const
+    {
+        fprintf(fp, "%-16s%s\n", "peephole rule", "hits");
+        for (int i = 0; i < PEEPHOLE_RULE_CNT; i++)
+        {
+            fprintf(fp, "%-16s%d\n", PEEPHOLE_RULES[i].name, ruleHits[i]);
+        }
+    }
+}
@@ -0,0 +1,210 @@
+/*
+    Optimizer of linked PCODE of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _SCC_OPTIMIZER_H_
+#define _SCC_OPTIMIZER_H_
+
+#include "parser.h"
+
+#include "../../common/src/pcode.h"
+
+#include <cstdio>
+#include <map>
+#include <vector>
+#include <utility>
+
+namespace scc
+{
+    /**
+     * Effect summary of a function, including the effects of its callees
+     */
+    struct Effect
+    {
+        int begin;
+        int end;
+
+        bool readGlobal;
+        bool writeGlobal;
+        bool io;
+        bool recursive;
+        bool loop;
+
+        std::vector<int> callees;
+
+        Effect();
+
+        /**
+         * @return whether the result only depends on the parameters
+         */
+        bool pure() const;
+
+        /**
+         * @return whether the function is pure and always returns
+         */
+        bool removable() const;
+    };
+
+    /**
+     * Accesses to a global scalar
+     */
+    struct GlobalUse
+    {
+        std::vector<int> reads;
+        std::vector<int> writes;
+        bool array;
+        bool outside;
+
+        GlobalUse();
+    };
+
+    /**
+     * Peephole rule, replacing codes matching pattern by the codes generated by rewrite
+     */
+    struct PeepholeRule
+    {
+        static const int LEN_MAX = 3;
+
+        static const int ANY = -0x7fffffff - 1;
+
+        const char* name;
+
+        int len;
+
+        /**
+         * Codes to match, in which a == ANY matches any a
+         */
+        sci::BPcode pattern[LEN_MAX];
+
+        /**
+         * @param codes: the matched codes
+         * @param res: the codes to replace with, addresses in which are ips before replacing
+         * @return whether the rule applies
+         */
+        bool (*rewrite)(const sci::BPcode* codes, std::vector<sci::BPcode>& res);
+    };
+
+    /**
+     * Optimizer working on the linked pcode of a whole program,
+     * in which every address is already an absolute ip
+     */
+    class Optimizer
+    {
+    protected:
+
+        static const int ROTATE_MAX = 16;
+
+        static const long long EVAL_STEPS = 1 << 16;
+
+        static const PeepholeRule PEEPHOLE_RULES[];
+
+        static const int PEEPHOLE_RULE_CNT;
+
+        std::vector<sci::BPcode>& codes;
+
+        std::vector<Fun>& funVector;
+
+        std::vector<bool> isTarget;
+
+        std::vector<Effect> effects;
+
+        std::vector<int> funIndex;
+
+        std::vector<int> ruleHits;
+
+        void markTargets();
+
+        /**
+         * @return index of the function starting at addr in funVector, or -1
+         */
+        int funAt(int addr) const;
+
+        /**
+         * Build the call graph over funVector and compute the effect summary
+         * of each function
+         */
+        void analyzeEffects();
+
+        /**
+         * Replace codes[it.first] by it.second for each patch, in which
+         * addresses are still ips before patching, then relocate all addresses
+         *
+         * @param patches: patches sorted by position
+         */
+        void patch(std::vector<std::pair<int, std::vector<sci::BPcode> > >& patches);
+
+        bool threadJumps();
+
+        bool invertBranches();
+
+        bool rotateLoops();
+
+        bool removeUnreachable();
+
+        bool removeDeadCalls();
+
+        /**
+         * Evaluate calls of pure functions with constant parameters,
+         * a call not returning in EVAL_STEPS instructions is kept
+         */
+        bool evalCalls();
+
+        /**
+         * Apply PEEPHOLE_RULES to codes, none of which except the first may be a jump target
+         */
+        bool peephole();
+
+        /**
+         * Collect accesses to each global by address
+         *
+         * @param mainId: index of main in funVector
+         */
+        void analyzeGlobals(int mainId, std::map<int, GlobalUse>& uses);
+
+        /**
+         * Replace globals never written, or only written once by a constant
+         * at the beginning of main before any call, by constants
+         */
+        bool constGlobals();
+
+        /**
+         * Turn globals only used in main into locals of main
+         */
+        bool localizeGlobals();
+
+    public:
+
+        Optimizer(std::vector<sci::BPcode>& codes, std::vector<Fun>& funVector);
+
+        virtual ~Optimizer();
+
+        void optimize();
+
+        const std::vector<Effect>& getEffects() const;
+
+        /**
+         * Print hit count of each peephole rule
+         */
+        void printStats(FILE* fp) const;
+    };
+}
+
+#endif // _SCC_OPTIMIZER_H_
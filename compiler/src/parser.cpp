@@ -20,7 +20,10 @@
 
 #include "lexer.h"
 #include "parser.h"
+#include "optimizer.h"
+#include "timereport.h"
 #include "trie"
+#include "hashtable"
 #include "define.h"
 
 #include "../../common/src/pcode.h"
@@ -32,32 +35,35 @@
 #include <cassert>
 
 #include <algorithm>
+#include <mutex>
 #include <vector>
 #include <string>
-#include <queue>
 
 namespace scc
 {
+    // struct VarScope
+
+    VarScope::VarScope() : stores(0), assigned(false), reachValid(false), reach(0), back(0)
+    {
+    }
+
     // struct Var
 
     Var::Var(VarType type) : type(type), global(false), writable(true), size(SINGLE)
     {
-        preAssign.emplace_back();
-        isPreAssign.push_back(false);
+        scopes.emplace_back();
     }
 
     Var::Var(VarType type, bool global, int addr, bool writable) :
             type(type), global(global), writable(writable), addr(addr), size(SINGLE)
     {
-        preAssign.emplace_back();
-        isPreAssign.push_back(false);
+        scopes.emplace_back();
     }
 
     Var::Var(VarType type, bool global, int addr, int size) :
             type(type), global(global), writable(true), addr(addr), size(size)
     {
-        preAssign.emplace_back();
-        isPreAssign.push_back(false);
+        scopes.emplace_back();
     }
 
     // struct Fun
@@ -66,37 +72,12 @@ namespace scc
     {
     }
 
-    // struct ExCode
-
-    ExCode::ExCode(unsigned f) : code{f}, id(0), remain(0),
-            fork(false), bg(INT_MAX >> 1), dependentVar(0)
-    {
-    }
-
-    ExCode::ExCode(unsigned f, int a) : code{f, a}, id(0), remain(0),
-            fork(false), bg(INT_MAX >> 1), dependentVar(0)
-    {
-    }
-
-    ExCode::ExCode(unsigned f, int a, int depCode) : code{f, a}, id(0), remain(0),
-            fork(false), bg(INT_MAX >> 1), dependentVar(0)
-    {
-        dependentCodes.push_back(depCode);
-    }
-
-    ExCode::ExCode(unsigned f, int a, int depCode1, int depCode2) : code{f, a}, id(0),
-            remain(0), fork(false), bg(INT_MAX >> 1), dependentVar(0)
-    {
-        dependentCodes.push_back(depCode1);
-        dependentCodes.push_back(depCode2);
-    }
-
     // class Parser
 
     bool Parser::EXPRESSION_SELECT[static_cast<unsigned>(TokenType::END)] = {false};
     bool Parser::STATEMENT_SELECT[static_cast<unsigned>(TokenType::END)] = {false};
 
-    bool Parser::hasInited = false;
+    std::once_flag Parser::initFlag;
 
     void Parser::init()
     {
@@ -119,96 +100,74 @@ namespace scc
         STATEMENT_SELECT[static_cast<unsigned>(TokenType::RETURNTK)] = true;
     }
 
-    Parser::Parser(bool optimize) : lexer(nullptr), h(0), size(0), lexFp(nullptr),
-            parserFp(nullptr), errorFp(nullptr), ip(0), loopCode(0), loopLevel(0),
-            optimize(optimize), hasError(false), global(true), globalSize(0), strSize(0)
+    Parser::Parser(bool optimize) : lexer(nullptr), h(-1), taken(0), lexTrace(nullptr),
+            parserTrace(nullptr), errorFp(nullptr), ownErrorFp(false), ip(0), report(nullptr),
+            reportFileName(nullptr), allocTime(), loopCode(0), loopLevel(0), optimize(optimize),
+            hasError(false), global(true), globalSize(0), strSize(0)
     {
-        if (!hasInited)
-        {
-            hasInited = true;
-            init();
-        }
+        // parsers may be constructed in many threads
+        std::call_once(initFlag, init);
     }
 
     Parser::~Parser()
     {
-        if (lexFp != nullptr && lexFp != stdout)
-        {
-            fclose(lexFp);
-        }
-        if (parserFp != nullptr && parserFp != lexFp && parserFp != stdout)
-        {
-            fclose(parserFp);
-        }
-        if (errorFp != nullptr && errorFp != stderr)
+        if (errorFp != nullptr && errorFp != stderr && ownErrorFp)
         {
             fclose(errorFp);
         }
         // TODO
     }
 
-    void Parser::setLexer(Lexer* lexer)
+    void Parser::setLexer(Lexer* lexer, bool threaded)
     {
         if (lexer == nullptr)
         {
             throw NullPointerError("Parser::setLexer: lexer is null");
         }
         this->lexer = lexer;
+        buffer.open(lexer, threaded);
+        h = -1;
+        taken = 0;
     }
 
+    void Parser::setReport(TimeReport* report, const char* fileName)
+    {
+        this->report = report;
+        reportFileName = fileName;
+        buffer.setTimed(report != nullptr);
+    }
 
     void Parser::open(const char* lexFileName, const char* parserFileName, const char* errorFileName)
     {
         if (lexFileName != nullptr)
         {
-            if (lexFp != nullptr && lexFp != stdout)
-            {
-                fclose(lexFp);
-            }
-            if (strcmp(lexFileName, "-") == 0)
-            {
-                lexFp = stdout;
-            }
-            else
-            {
-                lexFp = fopen(lexFileName, "w");
-            }
-            if (lexFp == nullptr)
-            {
-                throw FileError(lexFileName, "lexical analysis result");
-            }
+            lexWriter.open(lexFileName, "lexical analysis result");
+            lexTrace = &lexWriter;
         }
 
         if (parserFileName != nullptr)
         {
-            if (parserFp != nullptr && parserFp != stdout)
-            {
-                fclose(parserFp);
-            }
-            if (strcmp(parserFileName, "-") == 0)
+            // traces to the same file share a writer to keep their order
+            if (strcmp(parserFileName, "@") == 0 || (strcmp(parserFileName, "-") == 0 && lexTrace != nullptr
+                    && lexFileName != nullptr && strcmp(lexFileName, "-") == 0))
             {
-                parserFp = stdout;
-            }
-            else if (strcmp(parserFileName, "@") == 0)
-            {
-                parserFp = lexFp;
+                parserWriter.close();
+                parserTrace = lexTrace;
             }
             else
             {
-                parserFp = fopen(parserFileName, "w");
-            }
-            if (parserFp == nullptr)
-            {
-                throw FileError(parserFileName, "parsing result");
+                parserWriter.open(parserFileName, "parsing result");
+                parserTrace = &parserWriter;
             }
         }
 
         if (errorFileName != nullptr)
         {
-            if (errorFp != nullptr && errorFp != stderr)
+            if (errorFp != nullptr && errorFp != stderr && ownErrorFp)
             {
                 fclose(errorFp);
             }
+            ownErrorFp = true;
             if (strcmp(errorFileName, "-") == 0)
             {
                 errorFp = stderr;
@@ -224,22 +183,32 @@ namespace scc
         }
     }
 
-    void Parser::close()
+    void Parser::setErrorFile(FILE* fp)
     {
-        if (lexFp != nullptr && lexFp != stdout)
+        if (errorFp != nullptr && errorFp != stderr && ownErrorFp)
         {
-            fclose(lexFp);
+            fclose(errorFp);
         }
-        if (parserFp != nullptr && parserFp != lexFp && parserFp != stdout)
+        errorFp = fp;
+        ownErrorFp = false;
+    }
+
+    void Parser::close()
+    {
+        buffer.close();
+        if (report != nullptr)
         {
-            fclose(parserFp);
+            report->add(TimeReport::LEX, buffer.getLexTime());
+            report = nullptr;
         }
-        if (errorFp != nullptr && errorFp != stderr)
+        lexWriter.close();
+        parserWriter.close();
+        if (errorFp != nullptr && errorFp != stderr && ownErrorFp)
         {
             fclose(errorFp);
         }
-        lexFp = nullptr;
-        parserFp = nullptr;
+        lexTrace = nullptr;
+        parserTrace = nullptr;
         errorFp = nullptr;
     }
 
@@ -248,6 +217,38 @@ namespace scc
         return hasError;
     }
 
+    void Parser::link(bool verbose)
+    {
+        objCodes.clear();
+        objCodes.reserve(ip);
+        int n = codes.size();
+        for (int i = 0; i < n; i++)
+        {
+            if (codes.remain[i] >= static_cast<int>(optimize))
+            {
+                objCodes.push_back(codes.code[i]);
+            }
+        }
+
+        int linked = objCodes.size();
+        if (optimize)
+        {
+            Optimizer optimizer(objCodes, funVector);
+            optimizer.optimize();
+            if (verbose)
+            {
+                optimizer.printStats(errorFp);
+            }
+        }
+
+        ip = objCodes.size();
+        if (report != nullptr)
+        {
+            report->count(TimeReport::OPTIMIZED_CODES, linked - ip);
+            report->count(TimeReport::OBJECT_CODES, ip);
+        }
+    }
+
     void Parser::writeBin(const char* fileName)
     {
         assert(fileName != nullptr);
@@ -255,6 +256,9 @@ namespace scc
         FILE* fp;
         if (strcmp(fileName, "-") == 0)
         {
+            // after the traces to stdout
+            lexWriter.flush();
+            parserWriter.flush();
             fp = stdout;
         }
         else
@@ -301,12 +305,9 @@ namespace scc
         fwrite(&type, sizeof(sci::BPcodeBlockType), 1, fp);
         fwrite(&ip, sizeof(int), 1, fp);
 
-        for (const auto& it : codes)
+        for (const auto& it : objCodes)
         {
-            if (it.remain >= static_cast<int>(optimize))
-            {
-                fwrite(&it.code, sizeof(it.code), 1, fp);
-            }
+            fwrite(&it, sizeof(it), 1, fp);
         }
 
         fclose(fp);
@@ -319,6 +320,9 @@ namespace scc
         FILE* fp;
         if (strcmp(fileName, "-") == 0)
         {
+            // after the traces to stdout
+            lexWriter.flush();
+            parserWriter.flush();
             fp = stdout;
         }
         else
@@ -342,12 +346,9 @@ namespace scc
 
         fprintf(fp, "%s\n", sci::TPCODE_CODE);
 
-        for (const auto& it : codes)
+        for (const auto& it : objCodes)
         {
-            if (it.remain >= static_cast<int>(optimize))
-            {
-                fprintf(fp, "%s %u %d\n", sci::fs[it.code.f >> 3].name, it.code.f & 07, it.code.a);
-            }
+            fprintf(fp, "%s %u %d\n", sci::fs[it.f >> 3].name, it.f & 07, it.a);
         }
 
         fclose(fp);
@@ -355,24 +356,18 @@ namespace scc
 
     void Parser::nextToken(bool accept)
     {
-        if (accept && lexFp != nullptr)
+        if (accept && lexTrace != nullptr)
         {
-            fprintf(lexFp, "%s %s\n", scc::typeName[static_cast<unsigned>(buffer[h].type)],
-                    buffer[h].val.c_str());
+            lexTrace->writeToken(buffer[h]);
         }
-        ++h %= CACHE_MAX;
-        if (size > 0)
+        if (++h == taken)
         {
-            --size;
-        }
-        else
-        {
-            buffer[h].type = TokenType::NONE;
-            buffer[h].val.clear();
-            lexer->nextToken(buffer[h]);
+            taken++;
+            buffer.get(h);
             if (buffer[h].type == TokenType::INTERR)
             {
-                printErr(buffer[h].row, 'a', "invalid integer constant '%s'", buffer[h].val.c_str());
+                printErr(buffer[h].row, 'a', "invalid integer constant '%.*s'",
+                        buffer[h].val.size(), buffer[h].val.data());
                 buffer[h].type = TokenType::INTCON;
             }
             else if (buffer[h].type == TokenType::CHARERR)
@@ -382,28 +377,20 @@ namespace scc
             }
             else if (buffer[h].type == TokenType::NONE)
             {
-                printErr(buffer[h].row, 'a', "invalid token '%c'", buffer[h].val.c_str());
+                printErr(buffer[h].row, 'a', "invalid token '%.*s'",
+                        buffer[h].val.size(), buffer[h].val.data());
             }
         }
     }
 
     void Parser::rollback(unsigned n)
     {
-        h = (h - n + CACHE_MAX) % CACHE_MAX;
-        size += n;
+        h -= static_cast<int>(n);
     }
 
     Token& Parser::preToken(unsigned n)
     {
-        return buffer[(h - n + CACHE_MAX) % CACHE_MAX];
-    }
-
-    void Parser::print(const char* name)
-    {
-        if (parserFp != nullptr)
-        {
-            fputs(name, parserFp);
-        }
+        return buffer[h - n];
     }
 
     void Parser::printWarning(int row, char type, const char* format, ...)
@@ -443,22 +430,22 @@ namespace scc
 
     void Parser::findVar(Var*& var)
     {
-        int id = localTrie.cfind(buffer[h].val.c_str());
+        int id = localTable.cfind(SYMBOL_KEY(buffer[h]));
         if (id != 0)
         {
             var = localVector.data() + id - 1;
         }
         else
         {
-            id = globalTrie.cfind(buffer[h].val.c_str());
+            id = globalTable.cfind(SYMBOL_KEY(buffer[h]));
             if (id != 0)
             {
                 var = globalVector.data() + id - 1;
             }
             else
             {
-                printErr(buffer[h].row, 'c', "'%s' was not declared in this scope",
-                        buffer[h].val.c_str());
+                printErr(buffer[h].row, 'c', "'%.*s' was not declared in this scope",
+                        buffer[h].val.size(), buffer[h].val.data());
                 // TODO: ERROR
                 var = nullptr;
             }
@@ -483,7 +470,8 @@ namespace scc
         {
             if (!var->writable)
             {
-                printErr(token.row, 'j', "assignment of read-only variable '%s'", token.val.c_str());
+                printErr(token.row, 'j', "assignment of read-only variable '%.*s'",
+                        token.val.size(), token.val.data());
                 // TODO: ERROR
                 var = nullptr;
             }
@@ -507,6 +495,45 @@ namespace scc
         }
     }
 
+    VarScope& Parser::useScope(Var* var)
+    {
+        while (static_cast<int>(var->scopes.size()) <= loopLevel)
+        {
+            scopeVars[var->scopes.size()].push_back(var - localVector.data());
+            var->scopes.emplace_back();
+        }
+        return var->scopes[loopLevel];
+    }
+
+    int Parser::reachSet(Var* var, int level)
+    {
+        VarScope& scope = var->scopes[level];
+        if (!scope.reachValid)
+        {
+            // stores of outer levels reach the load unless the variable is surely assigned after them
+            scope.reach = scope.assigned || level == 0 ? scope.stores
+                    : codes.join(scope.stores, reachSet(var, level - 1));
+            scope.reachValid = true;
+        }
+        return scope.reach;
+    }
+
+    int Parser::backSet(Var* var, int level)
+    {
+        VarScope& scope = var->scopes[level];
+        if (scope.assigned || level == 0)
+        {
+            return 0;
+        }
+        if (scope.back == 0)
+        {
+            // outer levels are not assigned until the level ends
+            scope.back = codes.newSet();
+            codes.depend(scope.back, backSet(var, level - 1));
+        }
+        return scope.back;
+    }
+
     int Parser::loadVar(Var* var)
     {
         int res = 0;
@@ -515,27 +542,27 @@ namespace scc
         {
             if (var->writable)
             {
-                ExCode& preCode = codes.back();
+                int pre = codes.size() - 1;
+                sci::BPcode& preCode = codes.code[pre];
+                bool merge = codes.remain[pre] >= 0 && !codes.fork[pre] && optimize;
                 if (var->global)
                 {
-                    if (preCode.code.f == 0031 && preCode.code.a == var->addr
-                            && preCode.remain >= 0 && !preCode.fork && optimize)
+                    if (preCode.f == 0031 && preCode.a == var->addr && merge)
                     {
-                        preCode.code.f |= 2u;
+                        preCode.f |= 2u;
                     }
                     else
                     {
-                        codes.emplace_back(0021, var->addr);
+                        codes.push(0021, var->addr);
                     }
                 }
                 else
                 {
-                    if (preCode.code.f == 0030 && preCode.code.a == var->addr
-                            && preCode.remain >= 0 && !preCode.fork && optimize)
+                    if (preCode.f == 0030 && preCode.a == var->addr && merge)
                     {
-                        preCode.code.f |= 2u;
+                        preCode.f |= 2u;
                         res = codes.size() - 2;
-                        while (codes[res].code.f == 0032 && codes[res].remain >= 0)
+                        while (codes.code[res].f == 0032 && codes.remain[res] >= 0)
                         {
                             res--;
                         }
@@ -543,32 +570,17 @@ namespace scc
                     else
                     {
                         res = codes.size();
-                        codes.emplace_back(0020, var->addr);
-                        // TODO
-                        int bg = loopLevel; // TODO: FIXME
-                        while (bg >= 0 && !var->isPreAssign[bg])
-                        {
-                            --bg;
-                        }
-                        if (bg < 0)
-                        {
-                            bg = 0;
-                        }
-                        codes.back().bg = bg; // TODO: FIXME
-                        while (bg <= loopLevel)
-                        {
-                            codes.back().dependentCodes.insert(codes.back().dependentCodes.end(),
-                                    var->preAssign[bg].begin(), var->preAssign[bg].end());
-                            bg++;
-                        }
-                        codes.back().dependentVar = var - localVector.data();
+                        codes.push(0020, var->addr);
+                        useScope(var);
+                        codes.depend(res, reachSet(var, loopLevel));
+                        codes.depend(res, backSet(var, loopLevel));
                     }
                 }
             }
             else
             {
                 res = codes.size();
-                codes.emplace_back(0010, var->addr);
+                codes.push(0010, var->addr);
             }
         }
 
@@ -581,11 +593,11 @@ namespace scc
         {
             if (var->global)
             {
-                codes.emplace_back(0111, var->addr, depCode);
+                codes.push(0111, var->addr, depCode);
             }
             else
             {
-                codes.emplace_back(0110, var->addr, depCode);
+                codes.push(0110, var->addr, depCode);
             }
         }
     }
@@ -600,15 +612,16 @@ namespace scc
             }
             if (var->global)
             {
-                codes.emplace_back(0031, var->addr, depCode);
+                codes.push(0031, var->addr, depCode);
             }
             else
             {
-                var->preAssign.resize(loopLevel);
-                var->preAssign.emplace_back();
-                var->preAssign.back().push_back(codes.size());
-                var->isPreAssign.back() = true;
-                codes.emplace_back(0030, var->addr, depCode);
+                // the store hides those before it in the level
+                VarScope& scope = useScope(var);
+                scope.stores = codes.size();
+                scope.assigned = true;
+                scope.reachValid = false;
+                codes.push(0030, var->addr, depCode);
             }
         }
     }
@@ -623,51 +636,88 @@ namespace scc
             }
             if (var->global)
             {
-                codes.emplace_back(0121, var->addr, depCode1, depCode2);
+                codes.push(0121, var->addr, depCode1, depCode2);
             }
             else
             {
-                codes.emplace_back(0120, var->addr, depCode1, depCode2);
+                codes.push(0120, var->addr, depCode1, depCode2);
             }
         }
     }
 
     void Parser::allocAddr(int codesH)
     {
+        Clock start = report != nullptr ? Clock::now() : Clock();
         Fun& fun = funVector.back();
-        int n = codes.size();
-        int cur;
-        std::queue<int> q;
-        bool* vis = new bool[n - codesH];
-        memset(vis, false, (n - codesH) * sizeof(bool));
-        for (int i = n - 1; i >= codesH; --i)
+        int n = codes.size(), m = n - codesH;
+
+        // nodes are the codes, codesH + i as i, and the sets, -1 - i as m + i. Those each depends on
+        // are from deps[depH[i]] to deps[depH[i + 1]]
+        int cnt = m + codes.setCnt;
+        auto node = [codesH, m](int it)
         {
-            if (codes[i].remain == 1
-                || (codes[i].code.f != 0010 && codes[i].code.f != 0020 && codes[i].code.f != 0030
-                    && codes[i].code.f != 0032 && codes[i].code.f != 0100)
-                || (codes[i].code.f == 0100 && (codes[i].code.a < 2 || codes[i].code.a > 5)))
-            {
-                codes[i].remain = 1;
-                vis[i - codesH] = true;
-                q.push(i);
-            }
+            return it >= 0 ? it - codesH : m - 1 - it;
+        };
+        int* depH = arena.makeArray<int>(cnt + 1);
+        for (const auto& it : codes.edges)
+        {
+            depH[node(it.first)]++;
         }
-        while (!q.empty())
+        for (int i = 1; i <= cnt; i++)
         {
-            cur = q.front();
-            q.pop();
+            depH[i] += depH[i - 1];
+        }
+        int* deps = arena.makeArray<int>(depH[cnt]);
+        for (const auto& it : codes.edges)
+        {
+            deps[--depH[node(it.first)]] = node(it.second);
+        }
+        codes.edges.clear();
+        codes.setCnt = 0;
 
-            for (auto it : codes[cur].dependentCodes)
+        // codes mostly depend on earlier ones, so those kept are marked in one sweep backwards,
+        // with a stack only for sets and codes depended on after the sweep has passed them
+        signed char* remain = codes.remain.data() + codesH;
+        const sci::BPcode* code = codes.code.data() + codesH;
+        bool* kept = arena.makeArray<bool>(cnt);
+        int* stack = arena.makeArray<int>(cnt);
+        int top = 0;
+        auto keep = [&](int i, int cur)
+        {
+            for (int j = depH[i]; j < depH[i + 1]; j++)
+            {
+                int it = deps[j];
+                if (!kept[it])
+                {
+                    kept[it] = true;
+                    if (it < m)
+                    {
+                        remain[it] = 1;
+                    }
+                    if (it > cur)
+                    {
+                        stack[top++] = it;
+                    }
+                }
+            }
+        };
+        for (int i = m - 1; i >= 0; --i)
+        {
+            if (kept[i] || remain[i] == 1
+                || (code[i].f != 0010 && code[i].f != 0020 && code[i].f != 0030
+                    && code[i].f != 0032 && code[i].f != 0100)
+                || (code[i].f == 0100 && (code[i].a < 2 || code[i].a > 5)))
             {
-                if (it != 0 && !vis[it - codesH])
+                kept[i] = true;
+                remain[i] = 1;
+                keep(i, i);
+                while (top > 0)
                 {
-                    codes[it].remain = 1;
-                    vis[it - codesH] = true;
-                    q.push(it);
+                    keep(stack[--top], i);
                 }
             }
         }
-        delete[] vis;
+
         int addr = 2;
         n = localVector.size();
         for (int i = fun.paramTypes.size(); i < n; i++)
@@ -687,18 +737,20 @@ namespace scc
         }
         if (addr > 2)
         {
-            codes[codesH].code.a = addr - 2;
+            codes.code[codesH].a = addr - 2;
         }
-        else if (codes[codesH].code.f == 0050)
+        else if (codes.code[codesH].f == 0050)
         {
-            codes[codesH].remain = -1;
+            codes.remain[codesH] = -1;
         }
 
+        // ip of each code of the function
         n = codes.size();
+        int* id = arena.makeArray<int>(m);
         for (int i = codesH; i < n; i++)
         {
-            codes[i].id = ip;
-            if (codes[i].remain >= static_cast<int>(optimize))
+            id[i - codesH] = ip;
+            if (codes.remain[i] >= static_cast<int>(optimize))
             {
                 ip++;
             }
@@ -707,74 +759,86 @@ namespace scc
 
         for (int i = codesH; i < n; i++)
         {
-            if (codes[i].remain >= static_cast<int>(optimize))
+            if (codes.remain[i] >= static_cast<int>(optimize))
             {
-                switch (codes[i].code.f)
+                switch (codes.code[i].f)
                 {
                 case 0020:
                 case 0030:
                 case 0032:
                 case 0110:
                 case 0120:
-                    if (codes[i].code.a >= 0)
+                    if (codes.code[i].a >= 0)
                     {
-                        codes[i].code.a = localVector[codes[i].code.a].addr;
+                        codes.code[i].a = localVector[codes.code[i].a].addr;
                     }
                     break;
 
                 case 0060:
                 case 0070:
-                    codes[i].code.a = codes[codes[i].code.a].id;
+                    // a jump over the last else of a function may target its end
+                    codes.code[i].a = codes.code[i].a < n ? id[codes.code[i].a - codesH] : ip;
                     break;
                 }
             }
         }
+
+        // nothing of the function in the arena is used from now on
+        arena.reset();
+
+        if (report != nullptr)
+        {
+            Clock time = Clock::since(start);
+            allocTime += time;
+            report->addFunction(reportFileName, funName, m, time);
+#ifdef TRIE_SYMBOL
+            report->addTable("localTable", "Trie", localTable.nodes.size(), localTable.nodes.memory());
+#else
+            report->addTable("localTable", "HashTable", localTable.size(), localTable.memory());
+#endif
+        }
     }
 
     // class RecursiveParser
 
     void RecursiveParser::beginLoop()
     {
-        for (auto& it : localVector)
+        // variables get scopes in the level once used in it
+        if (static_cast<int>(scopeVars.size()) <= loopLevel)
         {
-            it.preAssign.resize(loopLevel + 1);
-            it.isPreAssign.push_back(false);
+            scopeVars.resize(loopLevel + 1);
         }
     }
 
     void RecursiveParser::endLoop(bool isLoop)
     {
-        if (isLoop)
+        for (int it : scopeVars[loopLevel])
         {
-            int n = codes.size();
-            for (int i = loopCode; i < n; ++i)
+            Var& var = localVector[it];
+            VarScope& scope = var.scopes[loopLevel];
+            if (isLoop && scope.back != 0)
             {
-                if (codes[i].bg < loopLevel)
-                {
-                    for (auto it : localVector[codes[i].dependentVar].preAssign[loopLevel])
-                    {
-                        codes[i].dependentCodes.push_back(it);
-                    }
-                }
+                codes.depend(scope.back, scope.stores);
             }
+            if (scope.stores != 0)
+            {
+                VarScope& outer = var.scopes[loopLevel - 1];
+                outer.stores = codes.join(scope.stores, outer.stores);
+                outer.reachValid = false;
+            }
+            var.scopes.pop_back();
         }
-        for (auto& it : localVector)
-        {
-            it.preAssign[loopLevel - 1].splice(it.preAssign[loopLevel - 1].begin(),
-                    std::move(it.preAssign[loopLevel]));
-            it.preAssign.resize(loopLevel);
-            it.isPreAssign.resize(loopLevel);
-        }
+        scopeVars[loopLevel].clear();
     }
 
     int RecursiveParser::str()
     {
         assert(buffer[h].type == TokenType::STRCON);
 
-        int& id = strTrie.at(buffer[h].val.c_str());
+        int& id = strTrie.at(buffer[h].val.data(), buffer[h].val.size());
         if (id == 0 || !optimize)
         {
-            strVector.emplace_back(buffer[h].val, globalSize + strSize);
+            strVector.emplace_back(buffer[h].val.str(), globalSize + strSize);
             id = strVector.size();
             strSize += static_cast<int>(buffer[h].val.size() / sizeof(int)) + 1;
         }
@@ -798,7 +862,8 @@ namespace scc
             constDef();
             if (buffer[h].type != TokenType::SEMICN)
             {
-                printErr(preToken().row, 'k', "expect ';' after '%s'", preToken().val.c_str());
+                printErr(preToken().row, 'k', "expect ';' after '%.*s'",
+                        preToken().val.size(), preToken().val.data());
                 // TODO: ERROR
             }
             else
@@ -837,26 +902,26 @@ namespace scc
                 }
                 catch (const ParsingError& e)
                 {
-                    printErr(buffer[idH].row, 'o', "except numeric constant, not '%s'",
-                            buffer[h].val.c_str());
+                    printErr(buffer[idH].row, 'o', "except numeric constant, not '%.*s'",
+                            buffer[h].val.size(), buffer[h].val.data());
                 }
 
                 if (global)
                 {
-                    if (funTrie.cfind(buffer[idH].val.c_str()) != 0)
+                    if (funTable.cfind(SYMBOL_KEY(buffer[idH])) != 0)
                     {
-                        printErr(buffer[idH].row, 'b', "redeclaration of '%s'",
-                                buffer[idH].val.c_str());
+                        printErr(buffer[idH].row, 'b', "redeclaration of '%.*s'",
+                                buffer[idH].val.size(), buffer[idH].val.data());
                         // TODO: ERROR
                         continue;
                     }
                     else
                     {
-                        int& id = globalTrie.at(buffer[idH].val.c_str()); // TODO
+                        int& id = globalTable.at(SYMBOL_KEY(buffer[idH])); // TODO
                         if (id != 0) // TODO
                         {
-                            printErr(buffer[idH].row, 'b', "redeclaration of '%s'",
-                                    buffer[idH].val.c_str());
+                            printErr(buffer[idH].row, 'b', "redeclaration of '%.*s'",
+                                    buffer[idH].val.size(), buffer[idH].val.data());
                             // TODO: ERROR
                             continue;
                         }
@@ -871,11 +936,11 @@ namespace scc
                 }
                 else
                 {
-                    int& id = localTrie.at(buffer[idH].val.c_str()); // TODO
+                    int& id = localTable.at(SYMBOL_KEY(buffer[idH])); // TODO
                     if (id != 0)
                     {
-                        printErr(buffer[idH].row, 'b', "redeclaration of '%s'",
-                                buffer[idH].val.c_str());
+                        printErr(buffer[idH].row, 'b', "redeclaration of '%.*s'",
+                                buffer[idH].val.size(), buffer[idH].val.data());
                         // TODO: ERROR
                         continue;
                     }
@@ -905,8 +970,8 @@ namespace scc
                 nextToken();
                 if (buffer[h].type != TokenType::CHARCON)
                 {
-                    printErr(buffer[idH].row, 'o', "except character constant, not '%s'",
-                            buffer[h].val.c_str());
+                    printErr(buffer[idH].row, 'o', "except character constant, not '%.*s'",
+                            buffer[h].val.size(), buffer[h].val.data());
                     // TODO: ERROR
                 }
                 char data = buffer[h].val[0];
@@ -914,20 +979,20 @@ namespace scc
 
                 if (global)
                 {
-                    if (funTrie.cfind(buffer[idH].val.c_str()) != 0)
+                    if (funTable.cfind(SYMBOL_KEY(buffer[idH])) != 0)
                     {
-                        printErr(buffer[idH].row, 'b', "redeclaration of '%s'",
-                                buffer[idH].val.c_str());
+                        printErr(buffer[idH].row, 'b', "redeclaration of '%.*s'",
+                                buffer[idH].val.size(), buffer[idH].val.data());
                         // TODO: ERROR
                         continue;
                     }
                     else
                     {
-                        int& id = globalTrie.at(buffer[idH].val.c_str()); // TODO
+                        int& id = globalTable.at(SYMBOL_KEY(buffer[idH])); // TODO
                         if (id != 0) // TODO
                         {
-                            printErr(buffer[idH].row, 'b', "redeclaration of '%s'",
-                                    buffer[idH].val.c_str());
+                            printErr(buffer[idH].row, 'b', "redeclaration of '%.*s'",
+                                    buffer[idH].val.size(), buffer[idH].val.data());
                             // TODO: ERROR
                             continue;
                         }
@@ -942,11 +1007,11 @@ namespace scc
                 }
                 else
                 {
-                    int& id = localTrie.at(buffer[idH].val.c_str()); // TODO
+                    int& id = localTable.at(SYMBOL_KEY(buffer[idH])); // TODO
                     if (id != 0)
                     {
-                        printErr(buffer[idH].row, 'b', "redeclaration of '%s'",
-                                buffer[idH].val.c_str());
+                        printErr(buffer[idH].row, 'b', "redeclaration of '%.*s'",
+                                buffer[idH].val.size(), buffer[idH].val.data());
                         // TODO: ERROR
                         continue;
                     }
@@ -978,7 +1043,7 @@ namespace scc
         print("<无符号整数>\n");
         try
         {
-            return std::stoi(preToken().val);
+            return std::stoi(preToken().val.str());
         }
         catch(const std::invalid_argument& e)
         {
@@ -1038,15 +1103,22 @@ namespace scc
             // TODO: ERROR
         }
 
-        if (globalTrie.cfind(buffer[h].val.c_str()) != 0)
+        if (report != nullptr)
         {
-            printErr(buffer[h].row, 'b', "redeclaration of '%s'", buffer[h].val.c_str());
+            funName.assign(buffer[h].val.data(), buffer[h].val.size());
+        }
+
+        if (globalTable.cfind(SYMBOL_KEY(buffer[h])) != 0)
+        {
+            printErr(buffer[h].row, 'b', "redeclaration of '%.*s'",
+                    buffer[h].val.size(), buffer[h].val.data());
             // TODO: ERROR
         }
-        int& id = funTrie.at(buffer[h].val.c_str());
+        int& id = funTable.at(SYMBOL_KEY(buffer[h]));
         if (id != 0)
         {
-            printErr(buffer[h].row, 'b', "redeclaration of '%s'", buffer[h].val.c_str());
+            printErr(buffer[h].row, 'b', "redeclaration of '%.*s'",
+                    buffer[h].val.size(), buffer[h].val.data());
             // TODO: ERROR
         }
         funVector.emplace_back(type, ip);
@@ -1064,7 +1136,8 @@ namespace scc
             varDef();
             if (buffer[h].type != TokenType::SEMICN)
             {
-                printErr(preToken().row, 'k', "expect ';' after '%s'", preToken().val.c_str());
+                printErr(preToken().row, 'k', "expect ';' after '%.*s'",
+                        preToken().val.size(), preToken().val.data());
                 // TODO: ERROR
             }
             else
@@ -1129,7 +1202,8 @@ namespace scc
                 }
                 if (buffer[h].type != TokenType::RBRACK)
                 {
-                    printErr(preToken().row, 'm', "except ']' after '%s'", preToken().val.c_str());
+                    printErr(preToken().row, 'm', "except ']' after '%.*s'",
+                            preToken().val.size(), preToken().val.data());
                     // TODO: ERROR
                 }
                 else
@@ -1140,18 +1214,20 @@ namespace scc
 
             if (global)
             {
-                if (funTrie.cfind(buffer[idH].val.c_str()) != 0)
+                if (funTable.cfind(SYMBOL_KEY(buffer[idH])) != 0)
                 {
-                    printErr(buffer[idH].row, 'b', "redeclaration of '%s'", buffer[idH].val.c_str());
+                    printErr(buffer[idH].row, 'b', "redeclaration of '%.*s'",
+                            buffer[idH].val.size(), buffer[idH].val.data());
                     // TODO: ERROR
                     continue;
                 }
                 else
                 {
-                    int& id = globalTrie.at(buffer[idH].val.c_str()); // TODO
+                    int& id = globalTable.at(SYMBOL_KEY(buffer[idH])); // TODO
                     if (id != 0) // TODO
                     {
-                        printErr(buffer[idH].row, 'b', "redeclaration of '%s'", buffer[idH].val.c_str());
+                        printErr(buffer[idH].row, 'b', "redeclaration of '%.*s'",
+                                buffer[idH].val.size(), buffer[idH].val.data());
                         // TODO: ERROR
                         continue;
                     }
@@ -1174,10 +1250,11 @@ namespace scc
             }
             else
             {
-                int& id = localTrie.at(buffer[idH].val.c_str()); // TODO
+                int& id = localTable.at(SYMBOL_KEY(buffer[idH])); // TODO
                 if (id != 0)
                 {
-                    printErr(buffer[idH].row, 'b', "redeclaration of '%s'", buffer[idH].val.c_str());
+                    printErr(buffer[idH].row, 'b', "redeclaration of '%.*s'",
+                            buffer[idH].val.size(), buffer[idH].val.data());
                     // TODO: ERROR
                     continue;
                 }
@@ -1205,7 +1282,8 @@ namespace scc
         param();
         if (buffer[h].type != TokenType::RPARENT)
         {
-            printErr(preToken().row, 'l', "except ')' after '%s'", preToken().val.c_str());
+            printErr(preToken().row, 'l', "except ')' after '%.*s'",
+                    preToken().val.size(), preToken().val.data());
             // TODO: ERROR
         }
         else
@@ -1222,12 +1300,12 @@ namespace scc
         if (retStatus == RET_NONE)
         {
             printWarning(buffer[h].row, 'h', "no return statement in function returning non-void");
-            codes.emplace_back(0100, 0);
+            codes.push(0100, 0);
         }
         else if (retStatus == RET_PARTIAL)
         {
             printWarning(buffer[h].row, '\0', "control reaches end of non-void function");
-            codes.emplace_back(0100, 0);
+            codes.push(0100, 0);
         }
 
         if (buffer[h].type != TokenType::RBRACE)
@@ -1253,15 +1331,22 @@ namespace scc
             // TODO: ERROR
         }
 
-        if (globalTrie.cfind(buffer[h].val.c_str()) != 0)
+        if (report != nullptr)
+        {
+            funName.assign(buffer[h].val.data(), buffer[h].val.size());
+        }
+
+        if (globalTable.cfind(SYMBOL_KEY(buffer[h])) != 0)
         {
-            printErr(buffer[h].row, 'b', "redeclaration of '%s'", buffer[h].val.c_str());
+            printErr(buffer[h].row, 'b', "redeclaration of '%.*s'",
+                    buffer[h].val.size(), buffer[h].val.data());
             // TODO: ERROR
         }
-        int& id = funTrie.at(buffer[h].val.c_str());
+        int& id = funTable.at(SYMBOL_KEY(buffer[h]));
         if (id != 0)
         {
-            printErr(buffer[h].row, 'b', "redeclaration of '%s'", buffer[h].val.c_str());
+            printErr(buffer[h].row, 'b', "redeclaration of '%.*s'",
+                    buffer[h].val.size(), buffer[h].val.data());
             // TODO: ERROR
         }
         funVector.emplace_back(VarType::VOID, ip);
@@ -1276,7 +1361,8 @@ namespace scc
         param();
         if (buffer[h].type != TokenType::RPARENT)
         {
-            printErr(preToken().row, 'l', "except ')' after '%s'", preToken().val.c_str());
+            printErr(preToken().row, 'l', "except ')' after '%.*s'",
+                    preToken().val.size(), preToken().val.data());
             // TODO: ERROR
         }
         else
@@ -1291,7 +1377,7 @@ namespace scc
 
         if (compoundSt() != RET_ALL)
         {
-            codes.emplace_back(0100, 0);
+            codes.push(0100, 0);
         }
 
         if (buffer[h].type != TokenType::RBRACE)
@@ -1307,7 +1393,7 @@ namespace scc
 
     int RecursiveParser::compoundSt()
     {
-        codes.back().fork = true;
+        codes.fork.back() = true;
 
         if (buffer[h].type == TokenType::CONSTTK)
         {
@@ -1316,7 +1402,7 @@ namespace scc
         if (buffer[h].type == TokenType::INTTK || buffer[h].type == TokenType::CHARTK)
         {
             varBlock();
-            codes.emplace_back(0050);
+            codes.push(0050);
         }
 
         int retStatus = statementBlock(); // TODO: return
@@ -1344,7 +1430,7 @@ namespace scc
             {
                 // TODO: ERROR
             }
-            int* id = &localTrie.at(buffer[h].val.c_str());
+            int* id = &localTable.at(SYMBOL_KEY(buffer[h]));
             if (*id != 0)
             {
                 // TODO: ERROR
@@ -1375,7 +1461,7 @@ namespace scc
                 {
                     // TODO: ERROR
                 }
-                id = &localTrie.at(buffer[h].val.c_str());
+                id = &localTable.at(SYMBOL_KEY(buffer[h]));
                 if (*id != 0)
                 {
                     // TODO: ERROR
@@ -1409,8 +1495,12 @@ namespace scc
             // TODO: ERROR
         }
         funVector.emplace_back(VarType::VOID, ip);
-        funTrie.at(buffer[h].val.c_str()) = funVector.size();
-        codes[0].code.a = ip;
+        funTable.at(SYMBOL_KEY(buffer[h])) = funVector.size();
+        codes.code[0].a = ip;
+        if (report != nullptr)
+        {
+            funName = "main";
+        }
         nextToken();
         if (buffer[h].type != TokenType::LPARENT)
         {
@@ -1419,7 +1509,8 @@ namespace scc
         nextToken();
         if (buffer[h].type != TokenType::RPARENT)
         {
-            printErr(preToken().row, 'l', "except ')' after '%s'", preToken().val.c_str());
+            printErr(preToken().row, 'l', "except ')' after '%.*s'",
+                    preToken().val.size(), preToken().val.data());
             // TODO: ERROR
         }
         else
@@ -1434,7 +1525,7 @@ namespace scc
 
         if (compoundSt() != RET_ALL)
         {
-            codes.emplace_back(0100, 0);
+            codes.push(0100, 0);
         }
 
         if (buffer[h].type != TokenType::RBRACE)
@@ -1465,7 +1556,7 @@ namespace scc
         {
             nextToken();
             item(lastCode);
-            codes.emplace_back(0100, 1, lastCode);
+            codes.push(0100, 1, lastCode);
             lastCode = codes.size() - 1;
 
             type = VarType::INT;
@@ -1481,7 +1572,7 @@ namespace scc
             {
                 nextToken();
                 item(curCode);
-                codes.emplace_back(0100, 2, curCode, lastCode);
+                codes.push(0100, 2, curCode, lastCode);
 
                 type = VarType::INT;
             }
@@ -1489,7 +1580,7 @@ namespace scc
             {
                 nextToken();
                 item(curCode);
-                codes.emplace_back(0100, 3, curCode, lastCode);
+                codes.push(0100, 3, curCode, lastCode);
 
                 type = VarType::INT;
             }
@@ -1518,7 +1609,7 @@ namespace scc
             {
                 nextToken();
                 factor(curCode);
-                codes.emplace_back(0100, 4, curCode, lastCode);
+                codes.push(0100, 4, curCode, lastCode);
 
                 type = VarType::INT;
             }
@@ -1526,7 +1617,7 @@ namespace scc
             {
                 nextToken();
                 factor(curCode);
-                codes.emplace_back(0100, 5, curCode, lastCode);
+                codes.push(0100, 5, curCode, lastCode);
 
                 type = VarType::INT;
             }
@@ -1577,7 +1668,8 @@ namespace scc
 
                     if (buffer[h].type != TokenType::RBRACK)
                     {
-                        printErr(preToken().row, 'm', "except ']' after '%s'", preToken().val.c_str());
+                        printErr(preToken().row, 'm', "except ']' after '%.*s'",
+                                preToken().val.size(), preToken().val.data());
                         // TODO: ERROR
                     }
                     else
@@ -1607,7 +1699,8 @@ namespace scc
             expression(lastCode);
             if (buffer[h].type != TokenType::RPARENT)
             {
-                printErr(preToken().row, 'l', "except ')' after '%s'", preToken().val.c_str());
+                printErr(preToken().row, 'l', "except ')' after '%.*s'",
+                        preToken().val.size(), preToken().val.data());
                 // TODO: ERROR
             }
             else
@@ -1619,12 +1712,12 @@ namespace scc
         case TokenType::PLUS:
         case TokenType::MINU:
         case TokenType::INTCON:
-            codes.emplace_back(0010, integer());
+            codes.push(0010, integer());
             lastCode = codes.size() - 1;
             break;
 
         case TokenType::CHARCON:
-            codes.emplace_back(0010, static_cast<int>(buffer[h].val[0]));
+            codes.push(0010, static_cast<int>(buffer[h].val[0]));
             lastCode = codes.size() - 1;
             nextToken();
             type = VarType::CHAR;
@@ -1676,7 +1769,7 @@ namespace scc
             else
             {
                 rollback(1);
-                int id = funTrie.cfind(buffer[h].val.c_str());
+                int id = funTable.cfind(SYMBOL_KEY(buffer[h]));
                 if (id == 0)
                 {
                     // TODO: ERROR
@@ -1693,7 +1786,8 @@ namespace scc
             }
             if (buffer[h].type != TokenType::SEMICN)
             {
-                printErr(preToken().row, 'k', "expect ';' after '%s'", preToken().val.c_str());
+                printErr(preToken().row, 'k', "expect ';' after '%.*s'",
+                        preToken().val.size(), preToken().val.data());
                 // TODO: ERROR
             }
             else
@@ -1706,7 +1800,8 @@ namespace scc
             readSt();
             if (buffer[h].type != TokenType::SEMICN)
             {
-                printErr(preToken().row, 'k', "expect ';' after '%s'", preToken().val.c_str());
+                printErr(preToken().row, 'k', "expect ';' after '%.*s'",
+                        preToken().val.size(), preToken().val.data());
                 // TODO: ERROR
             }
             else
@@ -1719,7 +1814,8 @@ namespace scc
             writeSt();
             if (buffer[h].type != TokenType::SEMICN)
             {
-                printErr(preToken().row, 'k', "expect ';' after '%s'", preToken().val.c_str());
+                printErr(preToken().row, 'k', "expect ';' after '%.*s'",
+                        preToken().val.size(), preToken().val.data());
                 // TODO: ERROR
             }
             else
@@ -1736,7 +1832,8 @@ namespace scc
             returnSt();
             if (buffer[h].type != TokenType::SEMICN)
             {
-                printErr(preToken().row, 'k', "expect ';' after '%s'", preToken().val.c_str());
+                printErr(preToken().row, 'k', "expect ';' after '%.*s'",
+                        preToken().val.size(), preToken().val.data());
                 // TODO: ERROR
             }
             else
@@ -1789,7 +1886,8 @@ namespace scc
 
             if (buffer[h].type != TokenType::RBRACK)
             {
-                printErr(preToken().row, 'm', "except ']' after '%s'", preToken().val.c_str());
+                printErr(preToken().row, 'm', "except ']' after '%.*s'",
+                        preToken().val.size(), preToken().val.data());
                 // TODO: ERROR
             }
             else
@@ -1828,7 +1926,8 @@ namespace scc
         int lastCode = condition();
         if (buffer[h].type != TokenType::RPARENT)
         {
-            printErr(preToken().row, 'l', "except ')' after '%s'", preToken().val.c_str());
+            printErr(preToken().row, 'l', "except ')' after '%.*s'",
+                    preToken().val.size(), preToken().val.data());
             // TODO: ERROR
         }
         else
@@ -1837,7 +1936,7 @@ namespace scc
         }
 
         int jpcIp = codes.size();
-        codes.emplace_back(0070, lastCode);
+        codes.push(0070, 0, lastCode);
 
         int preLoopCode = loopCode;
         loopCode = codes.size();
@@ -1850,13 +1949,13 @@ namespace scc
         loopCode = preLoopCode;
         --loopLevel;
 
-        codes.back().fork = true;
+        codes.fork.back() = true;
 
         if (buffer[h].type == TokenType::ELSETK)
         {
             int jmpIp = codes.size();
-            codes.emplace_back(0060);
-            codes[jpcIp].code.a = codes.size();
+            codes.push(0060);
+            codes.code[jpcIp].a = codes.size();
 
             nextToken();
 
@@ -1873,16 +1972,16 @@ namespace scc
             loopCode = preLoopCode;
             --loopLevel;
 
-            codes[jmpIp].code.a = codes.size();
+            codes.code[jmpIp].a = codes.size();
 
-            codes.back().fork = true;
+            codes.fork.back() = true;
 
         }
         else
         {
             retStatus = retStatus1 & 1;
 
-            codes[jpcIp].code.a = codes.size();
+            codes.code[jpcIp].a = codes.size();
         }
 
         print("<条件语句>\n");
@@ -1906,49 +2005,49 @@ namespace scc
         case TokenType::LSS:
             nextToken();
             type = expression(curCode);
-            codes.emplace_back(0100, inv && optimize ? 11 : 8, curCode, lastCode);
+            codes.push(0100, inv && optimize ? 11 : 8, curCode, lastCode);
             lastCode = codes.size() - 1;
             break;
 
         case TokenType::LEQ:
             nextToken();
             type = expression(curCode);
-            codes.emplace_back(0100, inv && optimize ? 10 : 9, curCode, lastCode);
+            codes.push(0100, inv && optimize ? 10 : 9, curCode, lastCode);
             lastCode = codes.size() - 1;
             break;
 
         case TokenType::GRE:
             nextToken();
             type = expression(curCode);
-            codes.emplace_back(0100, inv && optimize ? 9 : 10, curCode, lastCode);
+            codes.push(0100, inv && optimize ? 9 : 10, curCode, lastCode);
             lastCode = codes.size() - 1;
             break;
 
         case TokenType::GEQ:
             nextToken();
             type = expression(curCode);
-            codes.emplace_back(0100, inv && optimize ? 8 : 11, curCode, lastCode);
+            codes.push(0100, inv && optimize ? 8 : 11, curCode, lastCode);
             lastCode = codes.size() - 1;
             break;
 
         case TokenType::EQL:
             nextToken();
             type = expression(curCode);
-            codes.emplace_back(0100, inv && optimize ? 13 : 12, curCode, lastCode);
+            codes.push(0100, inv && optimize ? 13 : 12, curCode, lastCode);
             lastCode = codes.size() - 1;
             break;
 
         case TokenType::NEQ:
             nextToken();
             type = expression(curCode);
-            codes.emplace_back(0100, inv && optimize ? 12 : 13, curCode, lastCode);
+            codes.push(0100, inv && optimize ? 12 : 13, curCode, lastCode);
             lastCode = codes.size() - 1;
             break;
 
         default:
             if (inv && optimize)
             {
-                codes.emplace_back(0100, 7, lastCode);
+                codes.push(0100, 7, lastCode);
                 lastCode = codes.size() - 1;
             }
             break;
@@ -1956,8 +2055,8 @@ namespace scc
 
         if (!optimize && inv)
         {
-            codes.emplace_back(0010, 0);
-            codes.emplace_back(0100, 12, codes.size() - 1, lastCode);
+            codes.push(0010, 0);
+            codes.push(0100, 12, codes.size() - 1, lastCode);
             lastCode = codes.size() - 1;
         }
 
@@ -1977,7 +2076,7 @@ namespace scc
 
         if (buffer[h].type == TokenType::WHILETK)
         {
-            codes.back().fork = true;
+            codes.fork.back() = true;
 
             nextToken();
             if (buffer[h].type != TokenType::LPARENT)
@@ -1995,7 +2094,8 @@ namespace scc
             int lastCode = condition();
             if (buffer[h].type != TokenType::RPARENT)
             {
-                printErr(preToken().row, 'l', "except ')' after '%s'", preToken().val.c_str());
+                printErr(preToken().row, 'l', "except ')' after '%.*s'",
+                        preToken().val.size(), preToken().val.data());
                 // TODO: ERROR
             }
             else
@@ -2004,15 +2104,15 @@ namespace scc
             }
 
             int jpcIp = codes.size();
-            codes.emplace_back(0070, lastCode);
+            codes.push(0070, 0, lastCode);
 
             retStatus = statement() & 1;
 
-            codes.emplace_back(0060, conditionIp);
+            codes.push(0060, conditionIp);
 
-            codes[jpcIp].code.a = codes.size();
+            codes.code[jpcIp].a = codes.size();
 
-            codes.back().fork = true;
+            codes.fork.back() = true;
 
             endLoop();
             loopCode = preLoopCode;
@@ -2027,13 +2127,14 @@ namespace scc
             loopLevel++;
             beginLoop();
 
-            codes.back().fork = true;
+            codes.fork.back() = true;
 
             nextToken();
             retStatus = statement();
             if (buffer[h].type != TokenType::WHILETK)
             {
-                printErr(buffer[h].row, 'n', "except 'while' before '%s'", buffer[h].val.c_str());
+                printErr(buffer[h].row, 'n', "except 'while' before '%.*s'",
+                        buffer[h].val.size(), buffer[h].val.data());
                 // TODO: ERROR
             }
             else
@@ -2048,7 +2149,8 @@ namespace scc
             int lastCode = condition(true);
             if (buffer[h].type != TokenType::RPARENT)
             {
-                printErr(preToken().row, 'l', "except ')' after '%s'", preToken().val.c_str());
+                printErr(preToken().row, 'l', "except ')' after '%.*s'",
+                        preToken().val.size(), preToken().val.data());
                 // TODO: ERROR
             }
             else
@@ -2056,7 +2158,7 @@ namespace scc
                 nextToken();
             }
 
-            codes.emplace_back(0070, doIp, lastCode);
+            codes.push(0070, doIp, lastCode);
 
             endLoop();
             loopCode = preLoopCode;
@@ -2091,11 +2193,12 @@ namespace scc
             VarType type = expression(lastCode);
             storeVar(var, type, lastCode); // NOTE: Cautious when optimize (i)
 
-            codes.back().fork = true;
+            codes.fork.back() = true;
 
             if (buffer[h].type != TokenType::SEMICN)
             {
-                printErr(preToken().row, 'k', "expect ';' after '%s'", preToken().val.c_str());
+                printErr(preToken().row, 'k', "expect ';' after '%.*s'",
+                        preToken().val.size(), preToken().val.data());
                 // TODO: ERROR
             }
             else
@@ -2112,7 +2215,8 @@ namespace scc
             lastCode = condition();
             if (buffer[h].type != TokenType::SEMICN)
             {
-                printErr(preToken().row, 'k', "expect ';' after '%s'", preToken().val.c_str());
+                printErr(preToken().row, 'k', "expect ';' after '%.*s'",
+                        preToken().val.size(), preToken().val.data());
                 // TODO: ERROR
             }
             else
@@ -2121,7 +2225,7 @@ namespace scc
             }
 
             int jpcIp = codes.size();
-            codes.emplace_back(0070, lastCode);
+            codes.push(0070, 0, lastCode);
 
             if (buffer[h].type != TokenType::IDENFR)
             {
@@ -2167,7 +2271,8 @@ namespace scc
             st = step();
             if (buffer[h].type != TokenType::RPARENT)
             {
-                printErr(preToken().row, 'l', "except ')' after '%s'", preToken().val.c_str());
+                printErr(preToken().row, 'l', "except ')' after '%.*s'",
+                        preToken().val.size(), preToken().val.data());
                 // TODO: ERROR
             }
             else
@@ -2179,23 +2284,23 @@ namespace scc
 
             lastCode = loadVar(varR);
 
-            codes.emplace_back(0010, st);
+            codes.push(0010, st);
 
             if (plus)
             {
-                codes.emplace_back(0100, 2, codes.size() - 1, lastCode);
+                codes.push(0100, 2, codes.size() - 1, lastCode);
             }
             else
             {
-                codes.emplace_back(0100, 3, codes.size() - 1, lastCode);
+                codes.push(0100, 3, codes.size() - 1, lastCode);
             }
 
             storeVar(var, VarType::INT, codes.size() - 1);
 
-            codes.emplace_back(0060, conditionIp);
-            codes[jpcIp].code.a = codes.size();
+            codes.push(0060, conditionIp);
+            codes.code[jpcIp].a = codes.size();
 
-            codes.back().fork = true;
+            codes.fork.back() = true;
 
             endLoop();
             loopCode = preLoopCode;
@@ -2225,10 +2330,11 @@ namespace scc
     {
         assert(buffer[h].type == TokenType::IDENFR);
 
-        int id = funTrie.cfind(buffer[h].val.c_str());
+        int id = funTable.cfind(SYMBOL_KEY(buffer[h]));
         if (id == 0)
         {
-            printErr(buffer[h].row, 'c', "'%s' was not declared in this scope", buffer[h].val.c_str());
+            printErr(buffer[h].row, 'c', "'%.*s' was not declared in this scope",
+                    buffer[h].val.size(), buffer[h].val.data());
             // TODO: ERROR
         }
         else
@@ -2250,7 +2356,8 @@ namespace scc
         paramVal(fun);
         if (buffer[h].type != TokenType::RPARENT)
         {
-            printErr(preToken().row, 'l', "except ')' after '%s'", preToken().val.c_str());
+            printErr(preToken().row, 'l', "except ')' after '%.*s'",
+                    preToken().val.size(), preToken().val.data());
             // TODO: ERROR
         }
         else
@@ -2261,22 +2368,22 @@ namespace scc
         int&& paramCnt = fun.paramTypes.size();
         if (paramCnt == 0)
         {
-            codes.emplace_back(0042, fun.addr);
+            codes.push(0042, fun.addr);
             if (!remain)
             {
-                codes.emplace_back(0000, 1);
+                codes.push(0000, 1);
             }
         }
         else
         {
-            codes.emplace_back(0040, fun.addr);
+            codes.push(0040, fun.addr);
             if (!remain)
             {
-                codes.emplace_back(0000, paramCnt);
+                codes.push(0000, paramCnt);
             }
             else if (paramCnt > 1)
             {
-                codes.emplace_back(0000, paramCnt - 1);
+                codes.push(0000, paramCnt - 1);
             }
         }
 
@@ -2289,10 +2396,11 @@ namespace scc
     {
         assert(buffer[h].type == TokenType::IDENFR);
 
-        int id = funTrie.cfind(buffer[h].val.c_str());
+        int id = funTable.cfind(SYMBOL_KEY(buffer[h]));
         if (id == 0)
         {
-            printErr(buffer[h].row, 'c', "'%s' was not declared in this scope", buffer[h].val.c_str());
+            printErr(buffer[h].row, 'c', "'%.*s' was not declared in this scope",
+                    buffer[h].val.size(), buffer[h].val.data());
             // TODO: ERROR
         }
         else
@@ -2314,7 +2422,8 @@ namespace scc
         paramVal(fun);
         if (buffer[h].type != TokenType::RPARENT)
         {
-            printErr(preToken().row, 'l', "except ')' after '%s'", preToken().val.c_str());
+            printErr(preToken().row, 'l', "except ')' after '%.*s'",
+                    preToken().val.size(), preToken().val.data());
             // TODO: ERROR
         }
         else
@@ -2322,11 +2431,11 @@ namespace scc
             nextToken();
         }
 
-        codes.emplace_back(0040, fun.addr);
+        codes.push(0040, fun.addr);
         int&& paramCnt = fun.paramTypes.size();
         if (paramCnt != 0)
         {
-            codes.emplace_back(0000, paramCnt);
+            codes.push(0000, paramCnt);
         }
 
         print("<无返回值函数调用语句>\n");
@@ -2342,7 +2451,7 @@ namespace scc
             VarType type;
             int lastCode;
             type = expression(lastCode); // TODO: judge
-            codes[lastCode].remain = 1;
+            codes.remain[lastCode] = 1;
             if (i < n && type != fun.paramTypes[i])
             {
                 printErr(preToken().row, 'e', "the type of 0th parameter mismatches");
@@ -2354,7 +2463,7 @@ namespace scc
                 nextToken();
                 int lastCode;
                 type = expression(lastCode); // TODO: judge
-                codes[lastCode].remain = 1;
+                codes.remain[lastCode] = 1;
                 if (i < n && type != fun.paramTypes[i])
                 {
                     printErr(preToken().row, 'e', "the type of %dth parameter mismatches", i);
@@ -2417,11 +2526,11 @@ namespace scc
             {
                 if (var->type == VarType::INT)
                 {
-                    codes.emplace_back(0100, 16);
+                    codes.push(0100, 16);
                 }
                 else
                 {
-                    codes.emplace_back(0100, 17);
+                    codes.push(0100, 17);
                 }
 
                 storeVar(var, var->type, codes.size() - 1);
@@ -2433,7 +2542,8 @@ namespace scc
 
         if (buffer[h].type != TokenType::RPARENT)
         {
-            printErr(preToken().row, 'l', "except ')' after '%s'", preToken().val.c_str());
+            printErr(preToken().row, 'l', "except ')' after '%.*s'",
+                    preToken().val.size(), preToken().val.data());
             // TODO: ERROR
         }
         else
@@ -2459,39 +2569,40 @@ namespace scc
 
         if (buffer[h].type == TokenType::STRCON)
         {
-            codes.emplace_back(0010, str());
-            codes.emplace_back(0100, 18, codes.size() - 1);
+            codes.push(0010, str());
+            codes.push(0100, 18, codes.size() - 1);
             if (buffer[h].type == TokenType::COMMA)
             {
                 nextToken();
                 if (expression(lastCode) == VarType::INT)
                 {
-                    codes.emplace_back(0100, 14, lastCode);
+                    codes.push(0100, 14, lastCode);
                 }
                 else
                 {
-                    codes.emplace_back(0100, 19, lastCode);
+                    codes.push(0100, 19, lastCode);
                 }
             }
             else
             {
-                codes.emplace_back(0100, 15);
+                codes.push(0100, 15);
             }
         }
         else if (EXPRESSION_SELECT[static_cast<unsigned>(buffer[h].type)])
         {
             if (expression(lastCode) == VarType::INT)
             {
-                codes.emplace_back(0100, 14, lastCode);
+                codes.push(0100, 14, lastCode);
             }
             else
             {
-                codes.emplace_back(0100, 19, lastCode);
+                codes.push(0100, 19, lastCode);
             }
         }
         if (buffer[h].type != TokenType::RPARENT)
         {
-            printErr(preToken().row, 'l', "except ')' after '%s'", preToken().val.c_str());
+            printErr(preToken().row, 'l', "except ')' after '%.*s'",
+                    preToken().val.size(), preToken().val.data());
             // TODO: ERROR
         }
         else
@@ -2530,7 +2641,8 @@ namespace scc
             }
             if (buffer[h].type != TokenType::RPARENT)
             {
-                printErr(preToken().row, 'l', "except ')' after '%s'", preToken().val.c_str());
+                printErr(preToken().row, 'l', "except ')' after '%.*s'",
+                        preToken().val.size(), preToken().val.data());
                 // TODO: ERROR
             }
             else
@@ -2540,8 +2652,8 @@ namespace scc
 
             // TODO: judge
 
-            codes.emplace_back(0030, -std::max(static_cast<int>(fun.paramTypes.size()), 1), lastCode);
-            codes.back().remain = 1;
+            codes.push(0030, -std::max(static_cast<int>(fun.paramTypes.size()), 1), lastCode);
+            codes.remain.back() = 1;
         }
         else
         {
@@ -2552,7 +2664,7 @@ namespace scc
             }
         }
 
-        codes.emplace_back(0100, 0);
+        codes.push(0100, 0);
 
         print("<返回语句>\n");
     }
@@ -2561,6 +2673,8 @@ namespace scc
     {
         assert(lexer != nullptr);
 
+        Clock start = report != nullptr ? Clock::now() : Clock();
+
         global = true;
 
         nextToken(false);
@@ -2595,13 +2709,13 @@ namespace scc
 
         global = false;
 
-        codes.emplace_back(0040);
-        codes.back().remain = 1;
+        codes.push(0040);
+        codes.remain.back() = 1;
         ++ip;
 
         while (true)
         {
-            localTrie.clear();
+            localTable.clear();
             localVector.clear();
             if (buffer[h].type == TokenType::INTTK || buffer[h].type == TokenType::CHARTK)
             {
@@ -2630,6 +2744,32 @@ namespace scc
 
         print("<程序>\n");
 
+        if (report != nullptr)
+        {
+            Clock time = Clock::since(start);
+            time -= allocTime;
+            if (!buffer.isThreaded())
+            {
+                // lexed in batches on demand
+                time -= buffer.getLexTime();
+            }
+            report->add(TimeReport::PARSE, time);
+            report->add(TimeReport::ALLOC_ADDR, allocTime);
+            report->count(TimeReport::TOKENS, taken);
+            report->count(TimeReport::CODES, codes.size());
+            report->count(TimeReport::REMOVED_CODES, std::count_if(codes.remain.begin(), codes.remain.end(),
+                    [this](signed char it) { return it < static_cast<int>(optimize); }));
+#ifdef TRIE_SYMBOL
+            report->addTable("globalTable", "DoubleArrayTrie", globalTable.nodes.size(),
+                    globalTable.nodes.memory());
+            report->addTable("funTable", "DoubleArrayTrie", funTable.nodes.size(), funTable.nodes.memory());
+#else
+            report->addTable("globalTable", "HashTable", globalTable.size(), globalTable.memory());
+            report->addTable("funTable", "HashTable", funTable.size(), funTable.memory());
+#endif
+            report->addTable("strTrie", "DoubleArrayTrie", strTrie.nodes.size(), strTrie.nodes.memory());
+        }
+
         // TODO
 
         return !hasError;
@@ -23,19 +23,35 @@
 #ifndef _SCC_PARSER_H_
 #define _SCC_PARSER_H_
 
+#include "arena.h"
 #include "lexer.h"
+#include "timereport.h"
+#include "trace.h"
+#include "tokenring.h"
 #include "trie"
+#include "hashtable"
 
 #include "../../common/src/pcode.h"
 
 #include <cstdio>
 #include <cstdarg>
 
+#include <mutex>
+
 #include <string>
 #include <vector>
-#include <list>
 #include <utility>
 
+/**
+ * Key of an identifier token in the symbol tables, where the hash table takes
+ * the hash from the lexer. Build with 'make symbol=trie' for the tries
+ */
+#ifdef TRIE_SYMBOL
+#define SYMBOL_KEY(token) (token).val.data(), (token).val.size()
+#else
+#define SYMBOL_KEY(token) (token).val.data(), (token).val.size(), (token).hash
+#endif
+
 namespace scc
 {
     enum class VarType
@@ -46,6 +62,30 @@ namespace scc
         INT,
     };
 
+    /**
+     * Stores of a local variable in a loop level, each set of them a node of the dependency graph
+     * of codes, 0 for none
+     */
+    struct VarScope
+    {
+        // stores which may be the last at the end of the level so far
+        int stores;
+
+        // whether the variable is surely assigned in the level
+        bool assigned;
+
+        // whether reach is up to date
+        bool reachValid;
+
+        // stores which may reach a load in the level, including those of outer levels
+        int reach;
+
+        // stores at the end of the loop, which reach loads before them in the next iteration
+        int back;
+
+        VarScope();
+    };
+
     struct Var
     {
         static const int SINGLE = -1;
@@ -56,9 +96,8 @@ namespace scc
         int addr;
         int size;
 
-        std::vector<std::list<int> > preAssign;
-
-        std::vector<bool> isPreAssign;
+        // from the function level to the innermost loop level the variable is used in
+        std::vector<VarScope> scopes;
 
         explicit Var(VarType type);
 
@@ -76,26 +115,79 @@ namespace scc
         Fun(VarType returnType, int addr);
     };
 
-    struct ExCode
+    /**
+     * Codes of the program as an array of each field. The codes each depends on are logged as edges,
+     * which allocAddr gathers into adjacency arrays once the function is parsed. Sets of codes may
+     * also be depended on, numbered -1, -2, ...
+     */
+    struct CodeBuffer
     {
-        sci::BPcode code;
-        int id;
-        short remain;
-        bool fork;
-
-        int bg;
-
-        std::vector<int> dependentCodes;
-
-        int dependentVar;
-
-        explicit ExCode(unsigned f);
-
-        ExCode(unsigned f, int a);
-
-        ExCode(unsigned f, int a, int depCode);
-
-        ExCode(unsigned f, int a, int depCode1, int depCode2);
+        std::vector<sci::BPcode> code;
+
+        // 1 if kept, 0 if kept unless optimized, -1 if removed
+        std::vector<signed char> remain;
+
+        // whether a jump may land after the code, so that it is not merged with the next
+        std::vector<bool> fork;
+
+        // the code or set and one it depends on, of the function being parsed
+        std::vector<std::pair<int, int>> edges;
+
+        // count of sets of the function being parsed
+        int setCnt;
+
+        CodeBuffer() : setCnt(0)
+        {
+        }
+
+        int size() const
+        {
+            return code.size();
+        }
+
+        /**
+         * Append a code depending on depCode1 & depCode2, 0 for none
+         */
+        void push(unsigned f, int a = 0, int depCode1 = 0, int depCode2 = 0)
+        {
+            int i = code.size();
+            code.push_back({f, a});
+            remain.push_back(0);
+            fork.push_back(false);
+            depend(i, depCode1);
+            depend(i, depCode2);
+        }
+
+        void depend(int i, int depCode)
+        {
+            if (depCode != 0)
+            {
+                edges.emplace_back(i, depCode);
+            }
+        }
+
+        /**
+         * @return an empty set, which codes may be added to by depend
+         */
+        int newSet()
+        {
+            return -++setCnt;
+        }
+
+        /**
+         * @return the union of two sets or codes, 0 for none
+         */
+        int join(int a, int b)
+        {
+            if (a == 0 || b == 0)
+            {
+                return a | b;
+            }
+            int res = newSet();
+            depend(res, a);
+            depend(res, b);
+            return res;
+        }
     };
 
     class Parser
@@ -104,21 +196,44 @@ namespace scc
 
         Lexer* lexer;
 
-        static const int CACHE_MAX = 8;
+        TokenRing buffer;
 
-        Token buffer[CACHE_MAX];
+        // position of the current token & count of tokens taken from buffer
+        int h, taken;
 
-        int h, size;
+        TraceWriter lexWriter;
 
-        FILE *lexFp;
+        TraceWriter parserWriter;
 
-        FILE *parserFp;
+        // lexWriter, parserWriter, or nullptr if not traced; both point to lexWriter for the same file
+        TraceWriter* lexTrace;
+
+        TraceWriter* parserTrace;
 
         FILE *errorFp;
 
+        // whether errorFp is opened by the parser
+        bool ownErrorFp;
+
         int ip;
 
-        std::vector<ExCode> codes;
+        CodeBuffer codes;
+
+        // scratch of allocAddr, reset after each function
+        Arena arena;
+
+        // where times and counts are added, nullptr if not reported
+        TimeReport* report;
+
+        const char* reportFileName;
+
+        // name of the function being parsed, kept only if reported
+        std::string funName;
+
+        // time of allocAddr in the file, which the time of parsing excludes
+        Clock allocTime;
+
+        std::vector<sci::BPcode> objCodes;
 
         int loopCode;
 
@@ -134,18 +249,31 @@ namespace scc
 
         int strSize;
 
-        Trie<int, '0', 'z'> globalTrie;
+#ifdef TRIE_SYMBOL
+        // mostly looked up, so double arrays are compact and fast (see tools/src/triebench.cpp)
+        Trie<int, '0', 'z', DoubleArrayLayout> globalTable;
+
+        // cleared for each function, where dense nodes are the fastest to fill
+        Trie<int, '0', 'z'> localTable;
 
-        Trie<int, '0', 'z'> localTrie;
+        Trie<int, '0', 'z', DoubleArrayLayout> funTable;
+#else
+        HashTable<int> globalTable;
 
-        Trie<int, '0', 'z'> funTrie;
+        HashTable<int> localTable;
 
-        Trie<int> strTrie;
+        HashTable<int> funTable;
+#endif
+
+        Trie<int, static_cast<char>(32), static_cast<char>(126), DoubleArrayLayout> strTrie;
 
         std::vector<Var> globalVector;
 
         std::vector<Var> localVector;
 
+        // local variables with a scope in each loop level
+        std::vector<std::vector<int>> scopeVars;
+
         std::vector<Fun> funVector;
 
         std::vector<std::pair<std::string, int> > strVector;
@@ -154,7 +282,7 @@ namespace scc
 
         static bool STATEMENT_SELECT[static_cast<unsigned>(TokenType::END)];
 
-        static bool hasInited;
+        static std::once_flag initFlag;
 
         static void init();
 
@@ -164,7 +292,17 @@ namespace scc
 
         Token& preToken(unsigned n = 1);
 
-        void print(const char* name);
+        /**
+         * Print the name of a grammar unit, a literal whose length is known at compile time
+         */
+        template<int N>
+        void print(const char (&name)[N])
+        {
+            if (parserTrace != nullptr)
+            {
+                parserTrace->write(name, N - 1);
+            }
+        }
 
         void printWarning(int row, char type, const char* format, ...);
 
@@ -178,6 +316,24 @@ namespace scc
 
         void verifyElement(Var*& var, const Token& token);
 
+        /**
+         * Give the local variable a scope in each loop level up to the current one
+         *
+         * @return the scope of the current loop level
+         */
+        VarScope& useScope(Var* var);
+
+        /**
+         * @return set of stores of the local variable which may reach a load in the loop level
+         */
+        int reachSet(Var* var, int level);
+
+        /**
+         * @return set of stores at the ends of the loops around the level, which may reach a load in it
+         * in the next iteration
+         */
+        int backSet(Var* var, int level);
+
         int loadVar(Var* var);
 
         void loadElement(Var* var, int depCode);
@@ -194,16 +350,41 @@ namespace scc
 
         virtual ~Parser();
 
-        void setLexer(Lexer* lexer);
+        /**
+         * @param lexer: opened lexer, which must outlive close()
+         * @param threaded: whether the lexer runs ahead in a thread of its own
+         */
+        void setLexer(Lexer* lexer, bool threaded = false);
+
+        /**
+         * Add the times and counts of parsing, allocAddr and linking to report. Must be called
+         * before setLexer() for the time of lexing
+         *
+         * @param fileName: input file, which must outlive the parser
+         */
+        void setReport(TimeReport* report, const char* fileName);
 
         void open(const char* lexFileName, const char* parserFileName, const char* errorFileName);
 
+        /**
+         * Print errors into fp, which is left open by the parser
+         */
+        void setErrorFile(FILE* fp);
+
         void close();
 
         virtual bool parse() = 0;
 
         bool hasErr();
 
+        /**
+         * Collect remaining codes into object codes and optimize them if required.
+         * Must be called after parse() and before writeBin() / writeText()
+         *
+         * @param verbose: whether to print statistics of optimization with errors and warnings
+         */
+        void link(bool verbose = false);
+
         void writeBin(const char* fileName);
 
         void writeText(const char* fileName);
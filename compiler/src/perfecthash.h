@@ -0,0 +1,125 @@
+/*
+    Implementation of perfect hash.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _SCC_PERFECTHASH_H_
+#define _SCC_PERFECTHASH_H_
+
+#include "hashtable.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include <string>
+#include <vector>
+
+namespace scc
+{
+    /**
+     * Perfect hash of a fixed set of keys, where key k is in slot (fnvHash(k) * mult) >> shift,
+     * so a lookup is a multiplication and a memcmp.
+     * Like DFA, the tables may be built here or elsewhere
+     */
+    template<class T>
+    class PerfectHash
+    {
+    protected:
+
+        static const int MAX_TRIES = 1 << 16;
+
+        static const int MAX_SIZE = 1 << 16;
+
+        /**
+         * Point the tables to the buffers
+         */
+        void bind();
+
+        std::vector<T> dataBuffer;
+
+        std::vector<int> offsetBuffer;
+
+        std::string wordBuffer;
+
+    public:
+
+        const T DEFAULT_VAL;
+
+        /**
+         * Count of slots, a power of 2 no less than 2
+         */
+        int size;
+
+        unsigned mult;
+
+        int shift;
+
+        const T* data;
+
+        /**
+         * The key in slot i is words[offset[i], offset[i + 1]), empty if the slot is not used
+         */
+        const int* offset;
+
+        const char* words;
+
+        PerfectHash();
+
+        PerfectHash(const PerfectHash&) = delete;
+
+        virtual ~PerfectHash();
+
+        PerfectHash& operator=(const PerfectHash&) = delete;
+
+        /**
+         * Search for a multiplier, where a key found again is ignored
+         *
+         * @return false if no multiplier is found, as two keys have the same hash
+         */
+        bool build(const std::vector<std::string>& keys, const std::vector<T>& vals);
+
+        /**
+         * Use tables built elsewhere, which must outlive the PerfectHash
+         *
+         * @param data: data of each of the size slots
+         * @param offset: size + 1 offsets of the keys in words
+         */
+        void assign(int size, unsigned mult, const T* data, const int* offset, const char* words);
+
+        /**
+         * @param hash: fnvHash(key, len)
+         * @return the data of key, or DEFAULT_VAL if not found
+         */
+        const T& find(const char* key, int len, unsigned hash) const
+        {
+            int i = static_cast<int>((hash * mult) >> shift);
+            return offset[i + 1] - offset[i] == len && memcmp(words + offset[i], key, len) == 0
+                    ? data[i] : DEFAULT_VAL;
+        }
+
+        const T& find(const char* key, int len) const;
+
+        void clear();
+
+        void print(FILE* fp) const;
+    };
+}
+
+#endif // _SCC_PERFECTHASH_H_
@@ -0,0 +1,179 @@
+/*
+    Implementation of perfect hash.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _SCC_PERFECTHASH_TCC_
+#define _SCC_PERFECTHASH_TCC_
+
+#include "perfecthash.h"
+
+#include <cstdio>
+
+#include <string>
+#include <vector>
+
+namespace scc
+{
+    // class PerfectHash
+
+    template<class T>
+    const int PerfectHash<T>::MAX_TRIES;
+
+    template<class T>
+    const int PerfectHash<T>::MAX_SIZE;
+
+    template<class T>
+    PerfectHash<T>::PerfectHash() : DEFAULT_VAL()
+    {
+        clear();
+    }
+
+    template<class T>
+    PerfectHash<T>::~PerfectHash() = default;
+
+    template<class T>
+    void PerfectHash<T>::bind()
+    {
+        data = dataBuffer.data();
+        offset = offsetBuffer.data();
+        words = wordBuffer.data();
+    }
+
+    template<class T>
+    bool PerfectHash<T>::build(const std::vector<std::string>& keys, const std::vector<T>& vals)
+    {
+        std::vector<int> order;
+        std::vector<unsigned> hashes;
+        for (size_t i = 0; i < keys.size(); i++)
+        {
+            bool found = false;
+            for (int j : order)
+            {
+                found = found || keys[j] == keys[i];
+            }
+            if (!found)
+            {
+                order.push_back(static_cast<int>(i));
+                hashes.push_back(fnvHash(keys[i].data(), static_cast<int>(keys[i].size())));
+            }
+        }
+        int n = order.size();
+
+        // the table is at most half full, and doubled if no multiplier is found
+        int bits = 1;
+        while ((1 << bits) < n * 2)
+        {
+            bits++;
+        }
+        std::vector<int> slot;
+        unsigned seed = FNV_OFFSET;
+        for (; (1 << bits) <= MAX_SIZE; bits++)
+        {
+            for (int t = 0; t < MAX_TRIES; t++)
+            {
+                seed = seed * 1103515245u + 12345u;
+                unsigned m = seed | 1u;
+                slot.assign(1 << bits, -1);
+                int i = 0;
+                while (i < n && slot[(hashes[i] * m) >> (32 - bits)] == -1)
+                {
+                    slot[(hashes[i] * m) >> (32 - bits)] = order[i];
+                    i++;
+                }
+                if (i < n)
+                {
+                    continue;
+                }
+
+                size = 1 << bits;
+                mult = m;
+                shift = 32 - bits;
+                dataBuffer.assign(size, DEFAULT_VAL);
+                offsetBuffer.assign(1, 0);
+                wordBuffer.clear();
+                for (int s = 0; s < size; s++)
+                {
+                    if (slot[s] != -1)
+                    {
+                        dataBuffer[s] = vals[slot[s]];
+                        wordBuffer += keys[slot[s]];
+                    }
+                    offsetBuffer.push_back(static_cast<int>(wordBuffer.size()));
+                }
+                bind();
+                return true;
+            }
+        }
+        clear();
+        return false;
+    }
+
+    template<class T>
+    void PerfectHash<T>::assign(int size, unsigned mult, const T* data, const int* offset, const char* words)
+    {
+        dataBuffer.clear();
+        offsetBuffer.clear();
+        wordBuffer.clear();
+        this->size = size;
+        this->mult = mult;
+        shift = 32;
+        while ((1 << (32 - shift)) < size)
+        {
+            shift--;
+        }
+        this->data = data;
+        this->offset = offset;
+        this->words = words;
+    }
+
+    template<class T>
+    const T& PerfectHash<T>::find(const char* key, int len) const
+    {
+        return find(key, len, fnvHash(key, len));
+    }
+
+    template<class T>
+    void PerfectHash<T>::clear()
+    {
+        size = 2;
+        mult = 1;
+        shift = 31;
+        dataBuffer.assign(size, DEFAULT_VAL);
+        offsetBuffer.assign(size + 1, 0);
+        wordBuffer.clear();
+        bind();
+    }
+
+    template<class T>
+    void PerfectHash<T>::print(FILE* fp) const
+    {
+        for (int i = 0; i < size; i++)
+        {
+            if (offset[i + 1] != offset[i])
+            {
+                fprintf(fp, "%d<%d>: %.*s\n", i, static_cast<int>(data[i]), offset[i + 1] - offset[i],
+                        words + offset[i]);
+            }
+        }
+    }
+}
+
+#endif // _SCC_PERFECTHASH_TCC_
@@ -1,5 +1,5 @@
 /*
-    Regexp analyzer & Trie generator of SCC.
+    Regexp analyzer & NFA generator of SCC.
     Copyright (C) 2020-2021 Renjian Wang
 
     This file is part of SCC.
@@ -23,7 +23,7 @@
 #ifndef _SCC_REGEXP_H_
 #define _SCC_REGEXP_H_
 
-#include "trie"
+#include "dfa"
 
 #include <cstdio>
 #include <vector>
@@ -36,7 +36,7 @@ namespace scc
     {
     protected:
 
-        Trie<T>& trie;
+        NFA<T>& nfa;
 
         T val;
 
@@ -50,9 +50,9 @@ namespace scc
 
         void expr();
 
-        void exprTail(std::vector<int>*& heads);
+        void exprTail(int& state);
 
-        void item(std::vector<int>*& heads);
+        void item(int& state);
 
         bool star();
 
@@ -70,11 +70,14 @@ namespace scc
 
     public:
 
-        explicit RegExp(Trie<T>& trie);
+        explicit RegExp(NFA<T>& nfa);
 
         virtual ~RegExp();
 
-        void analyze(const char* reg, const T& val); // TODO: Trie
+        /**
+         * Add reg to the NFA as an alternative from its start state, accepted as val
+         */
+        void analyze(const char* reg, const T& val);
     };
 }
 
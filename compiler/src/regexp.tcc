@@ -1,5 +1,5 @@
 /*
-    Regexp analyzer & Trie generator of SCC.
+    Regexp analyzer & NFA generator of SCC.
     Copyright (C) 2020-2021 Renjian Wang
 
     This file is part of SCC.
@@ -24,18 +24,16 @@
 #define _SCC_REGEXP_TCC_
 
 #include "regexp"
-#include "trie"
+#include "dfa"
 
 #include "../../common/src/exception.h"
 
-#include <cstring>
-
 namespace scc
 {
     // class RegExp
 
     template<class T>
-    RegExp<T>::RegExp(Trie<T>& trie) : trie(trie)
+    RegExp<T>::RegExp(NFA<T>& nfa) : nfa(nfa)
     {
     }
 
@@ -54,12 +52,12 @@ namespace scc
         this->reg = reg;
         this->val = val;
         ch = nextChar();
-        if (ch >= trie.KEY_L && ch <= trie.KEY_R && ch != ']' && ch != '*' && ch != '|')
+        if (ch >= nfa.KEY_L && ch <= nfa.KEY_R && ch != ']' && ch != '*' && ch != '|')
         {
             expr();
             analyzeTail();
         }
-        else if (ch == ']' || ch == '*' || ch > trie.KEY_R)
+        else if (ch == ']' || ch == '*' || ch > nfa.KEY_R)
         {
             throw RegExpError("Unexpected character", ch);
         }
@@ -80,7 +78,7 @@ namespace scc
             expr();
             analyzeTail();
         }
-        else if (ch >= trie.KEY_L)
+        else if (ch >= nfa.KEY_L)
         {
             throw RegExpError("Unexpected character", ch);
         }
@@ -89,21 +87,14 @@ namespace scc
     template<class T>
     void RegExp<T>::expr()
     {
-        if (ch >= trie.KEY_L && ch <= trie.KEY_R && ch != ']' && ch != '*' && ch != '|')
+        if (ch >= nfa.KEY_L && ch <= nfa.KEY_R && ch != ']' && ch != '*' && ch != '|')
         {
-            std::vector<int>* heads = new std::vector<int>;
-            heads->push_back(0);
-            item(heads);
-            exprTail(heads);
-            for (auto it = heads->begin(); it != heads->end(); ++it)
-            {
-                if (trie.nodes[*it].data == trie.DEFAULT_VAL)
-                {
-                    trie.nodes[*it].data = val;
-                }
-            }
+            int state = 0;
+            item(state);
+            exprTail(state);
+            nfa.states[state].data = val;
         }
-        else if (ch == ']' || ch == '*' || ch > trie.KEY_R)
+        else if (ch == ']' || ch == '*' || ch > nfa.KEY_R)
         {
             throw RegExpError("Unexpected character", ch);
         }
@@ -114,21 +105,21 @@ namespace scc
     }
 
     template<class T>
-    void RegExp<T>::exprTail(std::vector<int>*& heads)
+    void RegExp<T>::exprTail(int& state)
     {
-        if (ch >= trie.KEY_L && ch <= trie.KEY_R && ch != ']' && ch != '*' && ch != '|')
+        if (ch >= nfa.KEY_L && ch <= nfa.KEY_R && ch != ']' && ch != '*' && ch != '|')
         {
-            item(heads);
-            exprTail(heads);
+            item(state);
+            exprTail(state);
         }
-        else if (!(ch < trie.KEY_L || ch == '|'))
+        else if (!(ch < nfa.KEY_L || ch == '|'))
         {
             throw RegExpError("Unexpected character", ch);
         }
     }
 
     template<class T>
-    void RegExp<T>::item(std::vector<int>*& heads)
+    void RegExp<T>::item(int& state)
     {
         if (ch == '[')
         {
@@ -140,89 +131,30 @@ namespace scc
                 throw RegExpError("Unexpected character", ch);
             }
             ch = nextChar();
-            bool isStar = star();
-            bool newNode = false;
-
-            if (!isStar)
+            int next = nfa.add();
+            if (!star())
             {
-                std::vector<int>* newHeads = new std::vector<int>;
-                for (auto itHeads = heads->begin(); itHeads != heads->end(); ++itHeads)
+                for (auto it = ranges.begin(); it != ranges.end(); ++it)
                 {
-                    for (auto itRanges = ranges.begin(); itRanges != ranges.end(); ++itRanges)
-                    {
-                        for (char c = itRanges->first; c <= itRanges->second; ++c)
-                        {
-                            if (trie.nodes[*itHeads].son[c - trie.KEY_L] == 0)
-                            {
-                                if (!newNode)
-                                {
-                                    newNode = true;
-                                    trie.nodes.emplace_back();
-                                }
-                                trie.nodes[*itHeads].son[c - trie.KEY_L] = trie.nodes.size() - 1;
-                            }
-                            newHeads->push_back(trie.nodes[*itHeads].son[c - trie.KEY_L]);
-                        }
-                    }
+                    nfa.link(state, it->first, it->second, next);
                 }
-                delete heads;
-                heads = newHeads;
             }
             else
             {
-                std::vector<int>* newHeads = new std::vector<int>(*heads);
-                bool *vis = new bool[trie.nodes.size() + 1];
-                memset(vis, 0, (trie.nodes.size() + 1) * sizeof(bool));
-                while (!heads->empty())
+                nfa.link(state, next);
+                for (auto it = ranges.begin(); it != ranges.end(); ++it)
                 {
-                    std::vector<int>* curHeads = new std::vector<int>;
-                    for (auto itHeads = heads->begin(); itHeads != heads->end(); ++itHeads)
-                    {
-                        vis[*itHeads] = true;
-                        for (auto itRanges = ranges.begin(); itRanges != ranges.end(); ++itRanges)
-                        {
-                            for (char c = itRanges->first; c <= itRanges->second; ++c)
-                            {
-                                if (trie.nodes[*itHeads].son[c - trie.KEY_L] == 0)
-                                {
-                                    if (!newNode)
-                                    {
-                                        newNode = true;
-                                        trie.nodes.emplace_back();
-                                    }
-                                    trie.nodes[*itHeads].son[c - trie.KEY_L] = trie.nodes.size() - 1;
-                                }
-                                if (!vis[trie.nodes[*itHeads].son[c - trie.KEY_L]])
-                                {
-                                    vis[trie.nodes[*itHeads].son[c - trie.KEY_L]] = true;
-                                    newHeads->push_back(trie.nodes[*itHeads].son[c - trie.KEY_L]);
-                                    curHeads->push_back(trie.nodes[*itHeads].son[c - trie.KEY_L]);
-                                }
-                            }
-                        }
-                    }
-                    delete heads;
-                    heads = curHeads;
+                    nfa.link(next, it->first, it->second, next);
                 }
-                delete[] vis;
-                delete heads;
-                heads = newHeads;
             }
- 
-            // TODO
+            state = next;
         }
-        else if (ch >= trie.KEY_L && ch <= trie.KEY_R && ch != ']' && ch != '*' && ch != '|')
+        else if (ch >= nfa.KEY_L && ch <= nfa.KEY_R && ch != ']' && ch != '*' && ch != '|')
         {
             char c = itemChar();
-            for (auto itHeads = heads->begin(); itHeads != heads->end(); ++itHeads)
-            {
-                if (trie.nodes[*itHeads].son[c - trie.KEY_L] == 0)
-                {
-                    trie.nodes.emplace_back();
-                    trie.nodes[*itHeads].son[c - trie.KEY_L] = trie.nodes.size() - 1;
-                }
-                *itHeads = trie.nodes[*itHeads].son[c - trie.KEY_L];
-            }
+            int next = nfa.add();
+            nfa.link(state, c, c, next);
+            state = next;
         }
         else if (ch == ']' || ch == '*')
         {
@@ -242,7 +174,7 @@ namespace scc
             ch = nextChar();
             return true;
         }
-        else if (ch > trie.KEY_R)
+        else if (ch > nfa.KEY_R)
         {
             throw RegExpError("Unexpected character", ch);
         }
@@ -252,7 +184,7 @@ namespace scc
     template<class T>
     void RegExp<T>::opt(std::vector< std::pair<char, char> >& ranges)
     {
-        if (ch >= trie.KEY_L && ch <= trie.KEY_R && ch != ']' && ch != '-')
+        if (ch >= nfa.KEY_L && ch <= nfa.KEY_R && ch != ']' && ch != '-')
         {
             optItem(ranges);
             optTail(ranges);
@@ -261,7 +193,7 @@ namespace scc
         {
             throw RegExpError("Cannot start with '-'", ch);
         }
-        else if (ch > trie.KEY_R)
+        else if (ch > nfa.KEY_R)
         {
             throw RegExpError("Unexpected character", ch);
         }
@@ -274,7 +206,7 @@ namespace scc
     template<class T>
     void RegExp<T>::optTail(std::vector< std::pair<char, char> >& ranges)
     {
-        if (ch >= trie.KEY_L && ch <= trie.KEY_R && ch != ']' && ch != '-')
+        if (ch >= nfa.KEY_L && ch <= nfa.KEY_R && ch != ']' && ch != '-')
         {
             optItem(ranges);
             optTail(ranges);
@@ -287,7 +219,7 @@ namespace scc
         {
             throw RegExpError("'-' is in the wrong place", ch);
         }
-        else if (ch > trie.KEY_R)
+        else if (ch > nfa.KEY_R)
         {
             throw RegExpError("Unexpected character", ch);
         }
@@ -300,7 +232,7 @@ namespace scc
     template<class T>
     void RegExp<T>::optItem(std::vector< std::pair<char, char> >& ranges)
     {
-        if (ch >= trie.KEY_L && ch <= trie.KEY_R && ch != ']' && ch != '-')
+        if (ch >= nfa.KEY_L && ch <= nfa.KEY_R && ch != ']' && ch != '-')
         {
             char optCh = optChar();
             ranges.emplace_back(optCh, range(optCh));
@@ -309,7 +241,7 @@ namespace scc
         {
             throw RegExpError("'-' is in the wrong place", ch);
         }
-        else if (ch > trie.KEY_R)
+        else if (ch > nfa.KEY_R)
         {
             throw RegExpError("Unexpected character", ch);
         }
@@ -327,11 +259,11 @@ namespace scc
             ch = nextChar();
             return optChar();
         }
-        else if (ch < trie.KEY_L)
+        else if (ch < nfa.KEY_L)
         {
             throw RegExpError("RegExp end unexpectedly", ch);
         }
-        else if (ch > trie.KEY_R)
+        else if (ch > nfa.KEY_R)
         {
             throw RegExpError("Unexpected character", ch);
         }
@@ -348,7 +280,7 @@ namespace scc
             ch = nextChar();
             return res;
         }
-        else if (ch >= trie.KEY_L && ch <= trie.KEY_R && ch != '[' && ch != ']' && ch != '*' && ch != '|')
+        else if (ch >= nfa.KEY_L && ch <= nfa.KEY_R && ch != '[' && ch != ']' && ch != '*' && ch != '|')
         {
             res = ch;
             ch = nextChar();
@@ -370,7 +302,7 @@ namespace scc
             ch = nextChar();
             return res;
         }
-        else if (ch >= trie.KEY_L && ch <= trie.KEY_R && ch != ']' && ch != '-')
+        else if (ch >= nfa.KEY_L && ch <= nfa.KEY_R && ch != ']' && ch != '-')
         {
             res = ch;
             ch = nextChar();
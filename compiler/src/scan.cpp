@@ -0,0 +1,236 @@
+/*
+    Vectorized scanning kernels of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "scan.h"
+#include "define.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#define SCAN_X86
+#include <immintrin.h>
+#endif
+
+namespace scc
+{
+    // scalar
+
+    static const char* findNonSpaceScalar(const char* p, const char* end)
+    {
+        while (p != end && *p <= ' ')
+        {
+            ++p;
+        }
+        return p;
+    }
+
+    static const char* findEolScalar(const char* p, const char* end)
+    {
+        while (p != end && *p != '\n')
+        {
+            ++p;
+        }
+        return p;
+    }
+
+    static const char* findStrEndScalar(const char* p, const char* end)
+    {
+        while (p != end && *p != '"' && *p >= ' ' && *p <= '~')
+        {
+            ++p;
+        }
+        return p;
+    }
+
+    static int countNewlinesScalar(const char* p, const char* end)
+    {
+        int cnt = 0;
+        for (; p != end; ++p)
+        {
+            cnt += *p == '\n';
+        }
+        return cnt;
+    }
+
+    static const ScanKernels SCALAR_KERNELS =
+    {
+        "scalar", findNonSpaceScalar, findEolScalar, findStrEndScalar, countNewlinesScalar
+    };
+
+#ifdef SCAN_X86
+
+    // SSE2, 16 bytes a time, the tail is left to scalar kernels
+
+    static const char* findNonSpaceSSE2(const char* p, const char* end)
+    {
+        const __m128i space = _mm_set1_epi8(' ');
+        for (; end - p >= 16; p += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            unsigned mask = _mm_movemask_epi8(_mm_cmpgt_epi8(v, space));
+            if (mask != 0)
+            {
+                return p + __builtin_ctz(mask);
+            }
+        }
+        return findNonSpaceScalar(p, end);
+    }
+
+    static const char* findEolSSE2(const char* p, const char* end)
+    {
+        const __m128i eol = _mm_set1_epi8('\n');
+        for (; end - p >= 16; p += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, eol));
+            if (mask != 0)
+            {
+                return p + __builtin_ctz(mask);
+            }
+        }
+        return findEolScalar(p, end);
+    }
+
+    static const char* findStrEndSSE2(const char* p, const char* end)
+    {
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i space = _mm_set1_epi8(' ');
+        const __m128i tilde = _mm_set1_epi8('~');
+        for (; end - p >= 16; p += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            __m128i stop = _mm_or_si128(_mm_cmpeq_epi8(v, quote),
+                    _mm_or_si128(_mm_cmplt_epi8(v, space), _mm_cmpgt_epi8(v, tilde)));
+            unsigned mask = _mm_movemask_epi8(stop);
+            if (mask != 0)
+            {
+                return p + __builtin_ctz(mask);
+            }
+        }
+        return findStrEndScalar(p, end);
+    }
+
+    static int countNewlinesSSE2(const char* p, const char* end)
+    {
+        const __m128i eol = _mm_set1_epi8('\n');
+        int cnt = 0;
+        for (; end - p >= 16; p += 16)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            cnt += __builtin_popcount(_mm_movemask_epi8(_mm_cmpeq_epi8(v, eol)));
+        }
+        return cnt + countNewlinesScalar(p, end);
+    }
+
+    static const ScanKernels SSE2_KERNELS =
+    {
+        "sse2", findNonSpaceSSE2, findEolSSE2, findStrEndSSE2, countNewlinesSSE2
+    };
+
+    // AVX2, 32 bytes a time, the tail is left to SSE2 kernels
+
+    __attribute__((target("avx2")))
+    static const char* findNonSpaceAVX2(const char* p, const char* end)
+    {
+        const __m256i space = _mm256_set1_epi8(' ');
+        for (; end - p >= 32; p += 32)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            unsigned mask = _mm256_movemask_epi8(_mm256_cmpgt_epi8(v, space));
+            if (mask != 0)
+            {
+                return p + __builtin_ctz(mask);
+            }
+        }
+        return findNonSpaceSSE2(p, end);
+    }
+
+    __attribute__((target("avx2")))
+    static const char* findEolAVX2(const char* p, const char* end)
+    {
+        const __m256i eol = _mm256_set1_epi8('\n');
+        for (; end - p >= 32; p += 32)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, eol));
+            if (mask != 0)
+            {
+                return p + __builtin_ctz(mask);
+            }
+        }
+        return findEolSSE2(p, end);
+    }
+
+    __attribute__((target("avx2")))
+    static const char* findStrEndAVX2(const char* p, const char* end)
+    {
+        const __m256i quote = _mm256_set1_epi8('"');
+        const __m256i space = _mm256_set1_epi8(' ');
+        const __m256i tilde = _mm256_set1_epi8('~');
+        for (; end - p >= 32; p += 32)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            __m256i stop = _mm256_or_si256(_mm256_cmpeq_epi8(v, quote),
+                    _mm256_or_si256(_mm256_cmpgt_epi8(space, v), _mm256_cmpgt_epi8(v, tilde)));
+            unsigned mask = _mm256_movemask_epi8(stop);
+            if (mask != 0)
+            {
+                return p + __builtin_ctz(mask);
+            }
+        }
+        return findStrEndSSE2(p, end);
+    }
+
+    __attribute__((target("avx2")))
+    static int countNewlinesAVX2(const char* p, const char* end)
+    {
+        const __m256i eol = _mm256_set1_epi8('\n');
+        int cnt = 0;
+        for (; end - p >= 32; p += 32)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            cnt += __builtin_popcount(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, eol)));
+        }
+        return cnt + countNewlinesSSE2(p, end);
+    }
+
+    static const ScanKernels AVX2_KERNELS =
+    {
+        "avx2", findNonSpaceAVX2, findEolAVX2, findStrEndAVX2, countNewlinesAVX2
+    };
+
+#endif
+
+    static const ScanKernels& selectKernels()
+    {
+#ifdef SCAN_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return AVX2_KERNELS;
+        }
+        if (__builtin_cpu_supports("sse2"))
+        {
+            return SSE2_KERNELS;
+        }
+#endif
+        return SCALAR_KERNELS;
+    }
+
+    const ScanKernels& scanKernels = selectKernels();
+}
@@ -0,0 +1,82 @@
+/*
+    Vectorized scanning kernels of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _SCC_SCAN_H_
+#define _SCC_SCAN_H_
+
+namespace scc
+{
+    /**
+     * Kernels scanning [p, end) of the source, implemented with AVX2, SSE2 or
+     * plain C++, the best one supported by the CPU is chosen at runtime.
+     * Chars are signed as in the lexers, so non-ASCII chars are spaces
+     */
+    struct ScanKernels
+    {
+        const char* name;
+
+        /**
+         * @return the first char > ' ', or end
+         */
+        const char* (*findNonSpace)(const char* p, const char* end);
+
+        /**
+         * @return the first '\n', or end
+         */
+        const char* (*findEol)(const char* p, const char* end);
+
+        /**
+         * @return the first '"' or char out of [' ', '~'], or end
+         */
+        const char* (*findStrEnd)(const char* p, const char* end);
+
+        /**
+         * @return count of '\n'
+         */
+        int (*countNewlines)(const char* p, const char* end);
+    };
+
+    extern const ScanKernels& scanKernels;
+
+    /**
+     * Skip spaces, counting rows
+     *
+     * @return the first char > ' ', or end
+     */
+    inline const char* skipSpace(const char* p, const char* end, int& row)
+    {
+        // no space or a single ' ' between tokens is the common case
+        if (p == end || *p > ' ')
+        {
+            return p;
+        }
+        if (*p == ' ' && p + 1 != end && p[1] > ' ')
+        {
+            return p + 1;
+        }
+        const char* q = scanKernels.findNonSpace(p, end);
+        row += scanKernels.countNewlines(p, q);
+        return q;
+    }
+}
+
+#endif // _SCC_SCAN_H_
@@ -0,0 +1,328 @@
+/*
+    Compile server & client of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "server.h"
+#include "define.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+#include <string>
+#include <vector>
+
+#ifndef WINDOWS
+#include <csignal>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#endif
+
+namespace scc
+{
+#ifdef WINDOWS
+
+    bool serve(const char* socketName, int (*run)(int argc, char** argv))
+    {
+        fprintf(stderr, "%s: server is not supported on Windows\n", socketName);
+        return false;
+    }
+
+    bool request(const char* socketName, int argc, char** argv, int& status)
+    {
+        return false;
+    }
+
+#else
+
+    // a request is the length of the rest, sent with stdin, stdout & stderr, then the working directory
+    // and the arguments, each ended with '\0'. The reply is the exit status
+
+    static const int FD_CNT = 3;
+
+    static const char* serverSocketName = nullptr;
+
+    static bool setAddr(const char* socketName, sockaddr_un& addr)
+    {
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (strlen(socketName) >= sizeof(addr.sun_path))
+        {
+            errno = ENAMETOOLONG;
+            return false;
+        }
+        strcpy(addr.sun_path, socketName);
+        return true;
+    }
+
+    static bool readAll(int fd, void* data, size_t size)
+    {
+        char* p = static_cast<char*>(data);
+        while (size > 0)
+        {
+            ssize_t n = read(fd, p, size);
+            if (n <= 0)
+            {
+                if (n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            p += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    static bool writeAll(int fd, const void* data, size_t size)
+    {
+        const char* p = static_cast<const char*>(data);
+        while (size > 0)
+        {
+            ssize_t n = write(fd, p, size);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            p += n;
+            size -= n;
+        }
+        return true;
+    }
+
+    // workers waiting for or running requests, killed when the server stops
+    static std::vector<pid_t> workers;
+
+    static void stop(int)
+    {
+        unlink(serverSocketName);
+        for (pid_t it : workers)
+        {
+            if (it > 0)
+            {
+                kill(it, SIGTERM);
+            }
+        }
+        _exit(0);
+    }
+
+    /**
+     * Run the request on conn in the worker, which exits with its status
+     */
+    static void handle(int conn, int (*run)(int argc, char** argv))
+    {
+        unsigned len;
+        int fds[FD_CNT];
+        iovec iov = {&len, sizeof(len)};
+        char control[CMSG_SPACE(sizeof(fds))];
+        msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        cmsghdr* cmsg;
+        if (recvmsg(conn, &msg, MSG_WAITALL) != sizeof(len) || (cmsg = CMSG_FIRSTHDR(&msg)) == nullptr
+                || cmsg->cmsg_type != SCM_RIGHTS || cmsg->cmsg_len != CMSG_LEN(sizeof(fds)))
+        {
+            _exit(1);
+        }
+        memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+
+        std::vector<char> data(len);
+        if (!readAll(conn, data.data(), len) || len == 0 || data.back() != '\0')
+        {
+            _exit(1);
+        }
+        std::vector<char*> argv;
+        for (char* p = data.data(); p != data.data() + len; p += strlen(p) + 1)
+        {
+            argv.push_back(p);
+        }
+        if (argv.size() < 2 || chdir(argv[0]) != 0)
+        {
+            _exit(1);
+        }
+        for (int i = 0; i < FD_CNT; i++)
+        {
+            dup2(fds[i], i);
+            close(fds[i]);
+        }
+        clearerr(stdin);
+
+        int status = run(static_cast<int>(argv.size()) - 1, argv.data() + 1);
+        fflush(stdout);
+        fflush(stderr);
+        writeAll(conn, &status, sizeof(status));
+        _exit(status);
+    }
+
+    /**
+     * Fork a worker, which takes one request and exits
+     */
+    static pid_t spawn(int fd, int (*run)(int argc, char** argv))
+    {
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            signal(SIGINT, SIG_DFL);
+            signal(SIGTERM, SIG_DFL);
+            signal(SIGPIPE, SIG_DFL);
+            int conn;
+            while ((conn = accept(fd, nullptr, nullptr)) < 0)
+            {
+                if (errno != EINTR && errno != ECONNABORTED)
+                {
+                    _exit(1);
+                }
+            }
+            close(fd);
+            handle(conn, run);
+        }
+        return pid;
+    }
+
+    bool serve(const char* socketName, int (*run)(int argc, char** argv))
+    {
+        sockaddr_un addr;
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || !setAddr(socketName, addr))
+        {
+            fprintf(stderr, "%s: %s\n", socketName, strerror(errno));
+            return false;
+        }
+        unlink(socketName);
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, SOMAXCONN) != 0)
+        {
+            fprintf(stderr, "%s: %s\n", socketName, strerror(errno));
+            close(fd);
+            return false;
+        }
+
+        // workers are forked ahead, so that a request waits for neither accept nor fork,
+        // and one is left to accept while another runs on a single core
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        workers.assign(n > 1 ? n : 2, 0);
+        serverSocketName = socketName;
+        signal(SIGINT, stop);
+        signal(SIGTERM, stop);
+        signal(SIGPIPE, SIG_IGN);
+
+        for (auto& it : workers)
+        {
+            it = spawn(fd, run);
+        }
+        while (true)
+        {
+            // replace each worker done with a new one
+            pid_t pid = wait(nullptr);
+            if (pid < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            for (auto& it : workers)
+            {
+                if (it == pid)
+                {
+                    it = spawn(fd, run);
+                    break;
+                }
+            }
+        }
+    }
+
+    bool request(const char* socketName, int argc, char** argv, int& status)
+    {
+        sockaddr_un addr;
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0)
+        {
+            return false;
+        }
+        if (!setAddr(socketName, addr) || connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+        {
+            close(fd);
+            return false;
+        }
+
+        std::string data;
+        std::vector<char> cwd(FILENAME_MAX);
+        while (getcwd(cwd.data(), cwd.size()) == nullptr)
+        {
+            if (errno != ERANGE)
+            {
+                close(fd);
+                return false;
+            }
+            cwd.resize(cwd.size() * 2);
+        }
+        data.append(cwd.data()).push_back('\0');
+        for (int i = 0; i < argc; i++)
+        {
+            data.append(argv[i]).push_back('\0');
+        }
+
+        unsigned len = data.size();
+        int fds[FD_CNT] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+        iovec iov = {&len, sizeof(len)};
+        char control[CMSG_SPACE(sizeof(fds))];
+        memset(control, 0, sizeof(control));
+        msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+        memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+        fflush(stdout);
+        fflush(stderr);
+        if (sendmsg(fd, &msg, 0) != sizeof(len) || !writeAll(fd, data.data(), data.size()))
+        {
+            close(fd);
+            return false;
+        }
+        // the request is run once sent, so a lost reply is a failure rather than a reason to run it again
+        if (!readAll(fd, &status, sizeof(status)))
+        {
+            fprintf(stderr, "%s: connection closed by server\n", socketName);
+            status = 1;
+        }
+        close(fd);
+        return true;
+    }
+
+#endif
+}
@@ -0,0 +1,49 @@
+/*
+    Compile server & client of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _SCC_SERVER_H_
+#define _SCC_SERVER_H_
+
+namespace scc
+{
+    /**
+     * Serve requests on a Unix socket until SIGINT or SIGTERM. Each request is run by a worker forked
+     * from the server ahead of it, which inherits what the server has loaded and warmed, in the working
+     * directory and with the stdin, stdout and stderr of the client, so nothing but the exit status
+     * goes through the socket. Not supported on Windows
+     *
+     * @param socketName: path of the socket, replaced if it exists
+     * @param run: runs the arguments of a request, and returns the exit status
+     * @return false if the socket is not created
+     */
+    bool serve(const char* socketName, int (*run)(int argc, char** argv));
+
+    /**
+     * Run the arguments in a server, as if they were run here
+     *
+     * @param status: exit status of the request
+     * @return false if the server is not found, when nothing is run
+     */
+    bool request(const char* socketName, int argc, char** argv, int& status);
+}
+
+#endif // _SCC_SERVER_H_
@@ -0,0 +1,171 @@
+/*
+    Source buffer of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "source.h"
+#include "define.h"
+
+#include "../../common/src/exception.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifndef WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace scc
+{
+    // class SourceBuffer
+
+    SourceBuffer::SourceBuffer() : data(nullptr), size(0), mapSize(0)
+    {
+    }
+
+    SourceBuffer::~SourceBuffer()
+    {
+        close();
+    }
+
+    bool SourceBuffer::map(const char* fileName)
+    {
+#ifdef WINDOWS
+        return false;
+#else
+        int fd = ::open(fileName, O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0)
+        {
+            ::close(fd);
+            return false;
+        }
+
+        // reserve zeroed pages with one more byte for '\0', then map the file over them
+        size_t pageSize = sysconf(_SC_PAGESIZE);
+        size = st.st_size;
+        mapSize = (size + pageSize) / pageSize * pageSize;
+        void* p = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p != MAP_FAILED && mmap(p, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+        {
+            munmap(p, mapSize);
+            p = MAP_FAILED;
+        }
+        ::close(fd);
+        if (p == MAP_FAILED)
+        {
+            size = mapSize = 0;
+            return false;
+        }
+        data = static_cast<char*>(p);
+        return true;
+#endif
+    }
+
+    bool SourceBuffer::read(FILE* fp)
+    {
+        size_t capacity = CHUNK_SIZE;
+        data = static_cast<char*>(malloc(capacity + 1));
+        if (data == nullptr)
+        {
+            return false;
+        }
+        size_t n;
+        while ((n = fread(data + size, 1, capacity - size, fp)) > 0)
+        {
+            size += n;
+            if (size == capacity)
+            {
+                capacity <<= 1;
+                char* p = static_cast<char*>(realloc(data, capacity + 1));
+                if (p == nullptr)
+                {
+                    close();
+                    return false;
+                }
+                data = p;
+            }
+        }
+        data[size] = '\0';
+        return true;
+    }
+
+    void SourceBuffer::open(const char* fileName)
+    {
+        close();
+        if (strcmp(fileName, "-") == 0)
+        {
+            if (!read(stdin))
+            {
+                throw FileError(fileName, "input");
+            }
+        }
+        else if (!map(fileName))
+        {
+            FILE* fp = fopen(fileName, "rb");
+            if (fp == nullptr)
+            {
+                throw FileError(fileName, "input");
+            }
+            bool ok = read(fp);
+            fclose(fp);
+            if (!ok)
+            {
+                throw FileError(fileName, "input");
+            }
+        }
+    }
+
+    void SourceBuffer::close()
+    {
+        if (data == nullptr)
+        {
+            return;
+        }
+#ifndef WINDOWS
+        if (mapSize != 0)
+        {
+            munmap(data, mapSize);
+        }
+        else
+#endif
+        {
+            free(data);
+        }
+        data = nullptr;
+        size = mapSize = 0;
+    }
+
+    const char* SourceBuffer::begin() const
+    {
+        return data;
+    }
+
+    const char* SourceBuffer::end() const
+    {
+        return data + size;
+    }
+}
@@ -0,0 +1,82 @@
+/*
+    Source buffer of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _SCC_SOURCE_H_
+#define _SCC_SOURCE_H_
+
+#include <cstddef>
+#include <cstdio>
+
+namespace scc
+{
+    /**
+     * Whole source in memory, mapped from the file if possible,
+     * otherwise read in chunks. *end() is always '\0'
+     */
+    class SourceBuffer
+    {
+    protected:
+
+        static const size_t CHUNK_SIZE = 1 << 16;
+
+        char* data;
+
+        size_t size;
+
+        // size of mapping, 0 if not mapped
+        size_t mapSize;
+
+        bool map(const char* fileName);
+
+        /**
+         * @return whether the memory is allocated, nothing kept if not
+         */
+        bool read(FILE* fp);
+
+    public:
+
+        SourceBuffer();
+
+        SourceBuffer(const SourceBuffer&) = delete;
+
+        SourceBuffer& operator=(const SourceBuffer&) = delete;
+
+        ~SourceBuffer();
+
+        /**
+         * Load source file
+         *
+         * @param fileName: name of source file, "-" for stdin
+         *
+         * @exception throw FileError if fail
+         */
+        void open(const char* fileName);
+
+        void close();
+
+        const char* begin() const;
+
+        const char* end() const;
+    };
+}
+
+#endif // _SCC_SOURCE_H_
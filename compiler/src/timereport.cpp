@@ -0,0 +1,249 @@
+/*
+    Time report of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "timereport.h"
+#include "define.h"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifndef WINDOWS
+#include <sys/resource.h>
+#endif
+
+namespace scc
+{
+    /**
+     * @return CPU time of all threads of the process in ms
+     */
+    static double processCpu()
+    {
+#ifndef WINDOWS
+        timespec ts;
+        clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+        return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+#else
+        return 1e3 * std::clock() / CLOCKS_PER_SEC;
+#endif
+    }
+
+    /**
+     * Print s as a JSON string
+     */
+    static void printString(FILE* fp, const char* s)
+    {
+        fputc('"', fp);
+        for (; *s != '\0'; s++)
+        {
+            unsigned char c = *s;
+            if (c == '"' || c == '\\')
+            {
+                fputc('\\', fp);
+                fputc(c, fp);
+            }
+            else if (c < 0x20)
+            {
+                fprintf(fp, "\\u%04x", c);
+            }
+            else
+            {
+                fputc(c, fp);
+            }
+        }
+        fputc('"', fp);
+    }
+
+    // struct Clock
+
+    Clock Clock::now()
+    {
+        Clock res;
+        res.wall = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+#ifndef WINDOWS
+        timespec ts;
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+        res.cpu = ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+#else
+        res.cpu = 1e3 * std::clock() / CLOCKS_PER_SEC;
+#endif
+        return res;
+    }
+
+    // class TimeReport
+
+    const char* const TimeReport::PHASE_NAMES[PHASE_CNT] =
+    {
+        "readLang", "lex", "parse", "allocAddr", "link", "emit",
+    };
+
+    const char* const TimeReport::COUNT_NAMES[COUNT_CNT] =
+    {
+        "files", "tokens", "codes", "removedCodes", "optimizedCodes", "objectCodes",
+    };
+
+    TimeReport::TimeReport() : phases(), counts()
+    {
+        start.wall = Clock::now().wall;
+        start.cpu = processCpu();
+    }
+
+    void TimeReport::add(Phase phase, const Clock& time)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        phases[phase] += time;
+    }
+
+    void TimeReport::count(Count count, long long n)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        counts[count] += n;
+    }
+
+    void TimeReport::addFunction(const char* fileName, const std::string& name, int codeCnt, const Clock& time)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        functions.push_back({fileName, name, codeCnt, time});
+    }
+
+    void TimeReport::addTable(const char* name, const char* kind, int size, size_t memory)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& it : tables)
+        {
+            if (strcmp(it.name, name) == 0)
+            {
+                it.size = std::max(it.size, size);
+                it.memory = std::max(it.memory, memory);
+                return;
+            }
+        }
+        tables.push_back({name, kind, size, memory});
+    }
+
+    size_t TimeReport::peakRss()
+    {
+#ifndef WINDOWS
+        rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0)
+        {
+            // in KiB on Linux
+            return static_cast<size_t>(usage.ru_maxrss) << 10;
+        }
+#endif
+        return 0;
+    }
+
+    std::vector<TimeReport::Function> TimeReport::sortFunctions() const
+    {
+        std::vector<Function> res(functions);
+        std::stable_sort(res.begin(), res.end(), [](const Function& a, const Function& b)
+        {
+            return a.time.wall > b.time.wall;
+        });
+        return res;
+    }
+
+    void TimeReport::print(FILE* fp)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        double wall = Clock::now().wall - start.wall, cpu = processCpu() - start.cpu;
+
+        fprintf(fp, "time report of %lld file(s):\n", counts[FILES]);
+        fprintf(fp, "  %-16s %12s %12s %8s\n", "phase", "wall(ms)", "cpu(ms)", "wall(%)");
+        for (int i = 0; i < PHASE_CNT; i++)
+        {
+            fprintf(fp, "  %-16s %12.3f %12.3f %8.1f\n", PHASE_NAMES[i], phases[i].wall, phases[i].cpu,
+                    wall > 0 ? 100 * phases[i].wall / wall : 0.0);
+        }
+        // the phases of files compiled in threads may add up to more than the total
+        fprintf(fp, "  %-16s %12.3f %12.3f\n", "total", wall, cpu);
+
+        const int SLOWEST = 10;
+        std::vector<Function> sorted = sortFunctions();
+        fprintf(fp, "slowest allocAddr of %zu function(s):\n", sorted.size());
+        for (int i = 0; i < SLOWEST && i < static_cast<int>(sorted.size()); i++)
+        {
+            fprintf(fp, "  %-24s %12.3f ms %10d codes  %s\n", sorted[i].name.c_str(), sorted[i].time.wall,
+                    sorted[i].codeCnt, sorted[i].fileName.c_str());
+        }
+
+        fprintf(fp, "counts:\n");
+        for (int i = 0; i < COUNT_CNT; i++)
+        {
+            fprintf(fp, "  %-16s %12lld\n", COUNT_NAMES[i], counts[i]);
+        }
+
+        fprintf(fp, "symbol tables:\n");
+        for (const auto& it : tables)
+        {
+            fprintf(fp, "  %-16s %-16s %12d nodes %12zu bytes\n", it.name, it.kind, it.size, it.memory);
+        }
+
+        fprintf(fp, "peak RSS: %.1f MiB\n", peakRss() / 1048576.0);
+    }
+
+    void TimeReport::printJson(FILE* fp)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        double wall = Clock::now().wall - start.wall, cpu = processCpu() - start.cpu;
+
+        fprintf(fp, "{\n  \"total\": {\"wall\": %.3f, \"cpu\": %.3f},\n  \"phases\": {", wall, cpu);
+        for (int i = 0; i < PHASE_CNT; i++)
+        {
+            fprintf(fp, "%s\n    \"%s\": {\"wall\": %.3f, \"cpu\": %.3f}", i == 0 ? "" : ",", PHASE_NAMES[i],
+                    phases[i].wall, phases[i].cpu);
+        }
+
+        fprintf(fp, "\n  },\n  \"counts\": {");
+        for (int i = 0; i < COUNT_CNT; i++)
+        {
+            fprintf(fp, "%s\n    \"%s\": %lld", i == 0 ? "" : ",", COUNT_NAMES[i], counts[i]);
+        }
+
+        fprintf(fp, "\n  },\n  \"symbolTables\": [");
+        for (size_t i = 0; i < tables.size(); i++)
+        {
+            fprintf(fp, "%s\n    {\"name\": \"%s\", \"kind\": \"%s\", \"size\": %d, \"memory\": %zu}",
+                    i == 0 ? "" : ",", tables[i].name, tables[i].kind, tables[i].size, tables[i].memory);
+        }
+
+        fprintf(fp, "\n  ],\n  \"functions\": [");
+        std::vector<Function> sorted = sortFunctions();
+        for (size_t i = 0; i < sorted.size(); i++)
+        {
+            fprintf(fp, "%s\n    {\"file\": ", i == 0 ? "" : ",");
+            printString(fp, sorted[i].fileName.c_str());
+            fprintf(fp, ", \"name\": ");
+            printString(fp, sorted[i].name.c_str());
+            fprintf(fp, ", \"codes\": %d, \"wall\": %.3f, \"cpu\": %.3f}", sorted[i].codeCnt,
+                    sorted[i].time.wall, sorted[i].time.cpu);
+        }
+
+        fprintf(fp, "\n  ],\n  \"peakRss\": %zu\n}\n", peakRss());
+    }
+}
@@ -0,0 +1,183 @@
+/*
+    Time report of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _SCC_TIMEREPORT_H_
+#define _SCC_TIMEREPORT_H_
+
+#include <cstddef>
+#include <cstdio>
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace scc
+{
+    /**
+     * Wall time and CPU time of the calling thread, in ms
+     */
+    struct Clock
+    {
+        double wall;
+        double cpu;
+
+        static Clock now();
+
+        Clock& operator+=(const Clock& other)
+        {
+            wall += other.wall;
+            cpu += other.cpu;
+            return *this;
+        }
+
+        Clock& operator-=(const Clock& other)
+        {
+            wall -= other.wall;
+            cpu -= other.cpu;
+            return *this;
+        }
+
+        /**
+         * @return time from start to now
+         */
+        static Clock since(const Clock& start)
+        {
+            Clock res = now();
+            res -= start;
+            return res;
+        }
+    };
+
+    /**
+     * Time of each phase and counts of a run of scc, added to by the threads compiling each file
+     */
+    class TimeReport
+    {
+    public:
+
+        enum Phase
+        {
+            READ_LANG,
+            LEX,
+            PARSE,
+            ALLOC_ADDR,
+            LINK,
+            EMIT,
+            PHASE_CNT,
+        };
+
+        static const char* const PHASE_NAMES[PHASE_CNT];
+
+        enum Count
+        {
+            FILES,
+            TOKENS,
+            CODES,
+            // by allocAddr
+            REMOVED_CODES,
+            // by the optimizer after linking
+            OPTIMIZED_CODES,
+            OBJECT_CODES,
+            COUNT_CNT,
+        };
+
+        static const char* const COUNT_NAMES[COUNT_CNT];
+
+    protected:
+
+        struct Function
+        {
+            std::string fileName;
+            std::string name;
+            int codeCnt;
+            Clock time;
+        };
+
+        struct Table
+        {
+            const char* name;
+            const char* kind;
+            int size;
+            size_t memory;
+        };
+
+        std::mutex mutex;
+
+        Clock start;
+
+        Clock phases[PHASE_CNT];
+
+        long long counts[COUNT_CNT];
+
+        std::vector<Function> functions;
+
+        // the largest of each table in any file, or any function for local ones
+        std::vector<Table> tables;
+
+        /**
+         * @return functions by time of allocAddr, the longest first
+         */
+        std::vector<Function> sortFunctions() const;
+
+    public:
+
+        /**
+         * Start the total time
+         */
+        TimeReport();
+
+        TimeReport(const TimeReport&) = delete;
+
+        TimeReport& operator=(const TimeReport&) = delete;
+
+        void add(Phase phase, const Clock& time);
+
+        void count(Count count, long long n);
+
+        /**
+         * Add the time of allocAddr of a function
+         */
+        void addFunction(const char* fileName, const std::string& name, int codeCnt, const Clock& time);
+
+        /**
+         * Keep the size of a symbol table if it is the largest so far
+         *
+         * @param size: count of nodes of a trie, or keys of a hash table
+         * @param memory: bytes allocated
+         */
+        void addTable(const char* name, const char* kind, int size, size_t memory);
+
+        /**
+         * @return peak resident set size of the process in bytes, 0 if unknown
+         */
+        static size_t peakRss();
+
+        /**
+         * Print the report in text, with the slowest functions
+         */
+        void print(FILE* fp);
+
+        void printJson(FILE* fp);
+    };
+}
+
+#endif // _SCC_TIMEREPORT_H_
@@ -0,0 +1,139 @@
+/*
+    Token ring between lexer and parser of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "tokenring.h"
+#include "timereport.h"
+#include "define.h"
+
+#include <cassert>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace scc
+{
+    // class TokenRing
+
+    const int TokenRing::HISTORY;
+
+    TokenRing::TokenRing() : ring(CAPACITY), lexer(nullptr), threaded(false), tail(0), released(0),
+            done(false), stopped(false), avail(0), timed(false), lexTime()
+    {
+    }
+
+    TokenRing::~TokenRing()
+    {
+        close();
+    }
+
+    void TokenRing::open(Lexer* lexer, bool threaded)
+    {
+        close();
+        this->lexer = lexer;
+        this->threaded = threaded;
+        tail = 0;
+        released = 0;
+        done = false;
+        stopped = false;
+        avail = 0;
+        lexTime = Clock();
+        if (threaded)
+        {
+            producer = std::thread(&TokenRing::produce, this);
+        }
+    }
+
+    void TokenRing::close()
+    {
+        if (producer.joinable())
+        {
+            stopped = true;
+            producer.join();
+        }
+        lexer = nullptr;
+    }
+
+    bool TokenRing::fill(int last)
+    {
+        Clock start = timed ? Clock::now() : Clock();
+        int t = tail.load(std::memory_order_relaxed);
+        bool feof = false;
+        while (t < last && !feof)
+        {
+            Token& token = ring[t & (CAPACITY - 1)];
+            token.type = TokenType::NONE;
+            token.val.clear();
+            lexer->nextToken(token);
+            feof = token.type == TokenType::FEOF;
+            t++;
+        }
+        if (timed)
+        {
+            lexTime += Clock::since(start);
+        }
+        tail.store(t, std::memory_order_release);
+        return feof;
+    }
+
+    void TokenRing::produce()
+    {
+        while (!stopped.load(std::memory_order_relaxed))
+        {
+            int t = tail.load(std::memory_order_relaxed);
+            int limit = released.load(std::memory_order_acquire) - HISTORY + CAPACITY;
+            if (t >= limit)
+            {
+                std::this_thread::yield();
+            }
+            else if (fill(std::min(t + BATCH, limit)))
+            {
+                break;
+            }
+        }
+        done.store(true, std::memory_order_release);
+    }
+
+    void TokenRing::fetch(int pos)
+    {
+        assert(lexer != nullptr);
+
+        released.store(pos, std::memory_order_release);
+        while (true)
+        {
+            // the producer is done, or never started, so the ring is ours
+            bool own = !threaded || done.load(std::memory_order_acquire);
+            avail = tail.load(std::memory_order_acquire);
+            if (pos < avail)
+            {
+                return;
+            }
+            if (own)
+            {
+                // after FEOF, the lexer gives FEOF again
+                fill(std::min(pos + BATCH, pos - HISTORY + CAPACITY));
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+}
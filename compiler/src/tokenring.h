@@ -0,0 +1,159 @@
+/*
+    Token ring between lexer and parser of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _SCC_TOKENRING_H_
+#define _SCC_TOKENRING_H_
+
+#include "lexer.h"
+#include "timereport.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace scc
+{
+    /**
+     * Ring of tokens lexed ahead of the parser in batches, indexed by the position in the token stream.
+     * The lexer fills the slots in place, in the thread of the parser or in a thread of its own,
+     * and the HISTORY tokens before the one taken last stay for rollback and preToken
+     */
+    class TokenRing
+    {
+    protected:
+
+        static const int CAPACITY = 1 << 12;
+
+        static const int BATCH = 64;
+
+        std::vector<Token> ring;
+
+        Lexer* lexer;
+
+        bool threaded;
+
+        std::thread producer;
+
+        // count of tokens lexed, published by the producer every BATCH tokens
+        std::atomic<int> tail;
+
+        // position before which tokens but HISTORY ones may be overwritten, published by the parser
+        std::atomic<int> released;
+
+        std::atomic<bool> done;
+
+        std::atomic<bool> stopped;
+
+        // last tail seen by the parser
+        int avail;
+
+        // whether to add the time of each batch to lexTime, which only the thread lexing touches
+        bool timed;
+
+        Clock lexTime;
+
+        /**
+         * Lex into ring from tail up to last, or until FEOF
+         *
+         * @return whether FEOF is lexed
+         */
+        bool fill(int last);
+
+        void produce();
+
+        /**
+         * Lex or wait for more tokens until pos < avail
+         */
+        void fetch(int pos);
+
+    public:
+
+        static const int HISTORY = 16;
+
+        TokenRing();
+
+        TokenRing(const TokenRing&) = delete;
+
+        ~TokenRing();
+
+        TokenRing& operator=(const TokenRing&) = delete;
+
+        /**
+         * Start at position 0
+         *
+         * @param threaded: whether to lex in a thread of its own
+         */
+        void open(Lexer* lexer, bool threaded);
+
+        /**
+         * Stop the thread if any. The lexer is not closed
+         */
+        void close();
+
+        bool isThreaded() const
+        {
+            return threaded;
+        }
+
+        void setTimed(bool timed)
+        {
+            this->timed = timed;
+        }
+
+        /**
+         * @return time spent in the lexer, valid after close()
+         */
+        const Clock& getLexTime() const
+        {
+            return lexTime;
+        }
+
+        /**
+         * @param pos: in [p - HISTORY, p], where p is the last position taken by get
+         */
+        Token& operator[](int pos)
+        {
+            return ring[pos & (CAPACITY - 1)];
+        }
+
+        /**
+         * Take the token at pos, lexing or waiting for it if needed. Tokens after FEOF are all FEOF
+         *
+         * @param pos: 0, 1, 2... in turn
+         */
+        Token& get(int pos)
+        {
+            if (pos >= avail)
+            {
+                fetch(pos);
+            }
+            else if ((pos & (BATCH - 1)) == 0)
+            {
+                // let the producer reuse the slots behind
+                released.store(pos, std::memory_order_release);
+            }
+            return ring[pos & (CAPACITY - 1)];
+        }
+    };
+}
+
+#endif // _SCC_TOKENRING_H_
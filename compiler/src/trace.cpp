@@ -0,0 +1,94 @@
+/*
+    Trace writer of lexical analysis & parsing results of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "trace.h"
+#include "define.h"
+
+#include "../../common/src/exception.h"
+
+#include <cstdio>
+#include <cstring>
+
+namespace scc
+{
+    // class TraceWriter
+
+    TraceWriter::TraceWriter() : fp(nullptr), cur(nullptr), end(nullptr)
+    {
+    }
+
+    TraceWriter::~TraceWriter()
+    {
+        close();
+    }
+
+    void TraceWriter::open(const char* fileName, const char* fileType)
+    {
+        close();
+        if (strcmp(fileName, "-") == 0)
+        {
+            fp = stdout;
+        }
+        else
+        {
+            // text mode as before, so the trace is the same as written by fprintf
+            fp = fopen(fileName, "w");
+        }
+        if (fp == nullptr)
+        {
+            throw FileError(fileName, fileType);
+        }
+        buffer.resize(BUFFER_SIZE);
+        cur = buffer.data();
+        end = cur + BUFFER_SIZE;
+        for (unsigned i = 0; i < static_cast<unsigned>(TokenType::END); i++)
+        {
+            typeNameLen[i] = strlen(typeName[i]);
+        }
+    }
+
+    void TraceWriter::close()
+    {
+        if (fp == nullptr)
+        {
+            return;
+        }
+        flush();
+        if (fp == stdout)
+        {
+            fflush(fp);
+        }
+        else
+        {
+            fclose(fp);
+        }
+        fp = nullptr;
+        cur = end = nullptr;
+    }
+
+    void TraceWriter::flush()
+    {
+        if (fp != nullptr)
+        {
+            fwrite(buffer.data(), 1, cur - buffer.data(), fp);
+            cur = buffer.data();
+        }
+    }
+}
@@ -0,0 +1,132 @@
+/*
+    Trace writer of lexical analysis & parsing results of SCC.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#ifndef _SCC_TRACE_H_
+#define _SCC_TRACE_H_
+
+#include "lexer.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include <vector>
+
+namespace scc
+{
+    /**
+     * Writer of traces like "IDENFR a" and "<表达式>", copied into an owned buffer
+     * instead of formatted by stdio, which is written to the file when full
+     */
+    class TraceWriter
+    {
+    protected:
+
+        static const int BUFFER_SIZE = 1 << 18;
+
+        FILE* fp;
+
+        std::vector<char> buffer;
+
+        char* cur;
+
+        char* end;
+
+        // strlen of typeName, taken when opened as typeName is filled by readLang or loadLang
+        int typeNameLen[static_cast<unsigned>(TokenType::END)];
+
+    public:
+
+        TraceWriter();
+
+        TraceWriter(const TraceWriter&) = delete;
+
+        ~TraceWriter();
+
+        TraceWriter& operator=(const TraceWriter&) = delete;
+
+        /**
+         * Open trace file
+         *
+         * @param fileName: name of trace file, "-" for stdout
+         * @param fileType: type of file in the error message
+         *
+         * @exception throw FileError if fail
+         */
+        void open(const char* fileName, const char* fileType);
+
+        /**
+         * Flush, and close the file unless it is stdout
+         */
+        void close();
+
+        bool isOpen() const
+        {
+            return fp != nullptr;
+        }
+
+        void write(const char* s, int len)
+        {
+            if (len > end - cur)
+            {
+                flush();
+                if (len > end - cur)
+                {
+                    fwrite(s, 1, len, fp);
+                    return;
+                }
+            }
+            memcpy(cur, s, len);
+            cur += len;
+        }
+
+        /**
+         * Write "<type name> <value>\n"
+         */
+        void writeToken(const Token& token)
+        {
+            unsigned type = static_cast<unsigned>(token.type);
+            int nameLen = typeNameLen[type], valLen = token.val.size();
+            if (nameLen + valLen + 2 > end - cur)
+            {
+                flush();
+                if (nameLen + valLen + 2 > end - cur)
+                {
+                    fprintf(fp, "%s %.*s\n", typeName[type], valLen, token.val.data());
+                    return;
+                }
+            }
+            memcpy(cur, typeName[type], nameLen);
+            cur += nameLen;
+            *cur++ = ' ';
+            memcpy(cur, token.val.data(), valLen);
+            cur += valLen;
+            *cur++ = '\n';
+        }
+
+        /**
+         * Write the buffer to the file if open
+         */
+        void flush();
+    };
+}
+
+#endif // _SCC_TRACE_H_
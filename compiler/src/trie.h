@@ -25,28 +25,275 @@
 
 #include <cstdio>
 
+#include <utility>
 #include <vector>
 
 namespace scc
 {
-    template<class T, char _KEY_L = static_cast<char>(32), char _KEY_R = static_cast<char>(126)>
-    class Trie
+    /*
+     * Layouts of the nodes of a trie over N symbols [0, N), in which node 0 is the root and
+     * son 0 means none. A layout provides son, add, data, size, memory and clear, and the data
+     * of a node may move when another node is added, like the elements of a vector
+     */
+
+    /**
+     * Array of N sons in each node, the fastest and the largest
+     */
+    template<class T, int N>
+    class DenseLayout
     {
+    protected:
+
+        struct Node
+        {
+            int son[N];
+            T data;
+
+            Node();
+        };
+
+        std::vector<Node> nodes;
+
     public:
 
+        DenseLayout();
+
+        int son(int p, int c) const
+        {
+            return nodes[p].son[c];
+        }
+
+        /**
+         * @return son c of p, which is added if not found
+         */
+        int add(int p, int c);
+
+        T& data(int p)
+        {
+            return nodes[p].data;
+        }
+
+        const T& data(int p) const
+        {
+            return nodes[p].data;
+        }
+
+        /**
+         * @return count of nodes
+         */
+        int size() const;
+
+        /**
+         * @return bytes allocated
+         */
+        size_t memory() const;
+
+        void clear();
+    };
+
+    /**
+     * Sons sorted by symbol in each node, searched by bisection
+     */
+    template<class T, int N>
+    class SparseLayout
+    {
+    protected:
+
         struct Node
         {
-            int son[static_cast<unsigned>(_KEY_R - _KEY_L + 1)];
+            // (symbol, son)
+            std::vector<std::pair<int, int> > sons;
             T data;
 
             Node();
         };
 
+        std::vector<Node> nodes;
+
+    public:
+
+        SparseLayout();
+
+        int son(int p, int c) const;
+
+        int add(int p, int c);
+
+        T& data(int p)
+        {
+            return nodes[p].data;
+        }
+
+        const T& data(int p) const
+        {
+            return nodes[p].data;
+        }
+
+        int size() const;
+
+        size_t memory() const;
+
+        void clear();
+    };
+
+    /**
+     * Dense rows over classes of symbols, where a class is given to a symbol when it is
+     * first added, so rows are only as wide as the symbols in use.
+     * The rows are widened by doubling when they are full
+     */
+    template<class T, int N>
+    class ClassLayout
+    {
+    protected:
+
+        /**
+         * Change the width of all rows
+         */
+        void widen(int width);
+
+        // class of each symbol, 0 if not used
+        unsigned short classOf[N];
+
+        int classCnt;
+
+        int width;
+
+        // sons[p * width + k - 1] is the son of p on class k
+        std::vector<int> sons;
+
+        std::vector<T> datas;
+
+    public:
+
+        ClassLayout();
+
+        int son(int p, int c) const
+        {
+            int k = classOf[c];
+            return k == 0 ? 0 : sons[p * width + k - 1];
+        }
+
+        int add(int p, int c);
+
+        T& data(int p)
+        {
+            return datas[p];
+        }
+
+        const T& data(int p) const
+        {
+            return datas[p];
+        }
+
+        int size() const;
+
+        size_t memory() const;
+
+        void clear();
+    };
+
+    /**
+     * Double-array trie, where son c of p is base[p] + c if check[base[p] + c] == p.
+     * When a slot is taken, all sons of p move to a new base, so node numbers are not stable
+     */
+    template<class T, int N>
+    class DoubleArrayLayout
+    {
+    protected:
+
+        static const int FIND_TRIES = 256;
+
+        /**
+         * @param codes: symbols, ascending
+         * @return a base at which all the symbols are free slots
+         */
+        int findBase(const int* codes, int n) const;
+
+        /**
+         * Move sons of p and the new son c to a new base
+         *
+         * @param c: the new son, or -1 for none
+         * @param follow: changed to the new number if it is a son moved
+         */
+        void relocate(int p, int c, int& follow);
+
+        /**
+         * @return count of sons of p
+         */
+        int count(int p) const;
+
+        bool isFree(int q) const
+        {
+            return q >= tail || check[q] < 0;
+        }
+
+        /**
+         * Take free slot q as a son of p
+         */
+        void take(int q, int p);
+
+        void release(int q);
+
+        void reserve(int n);
+
+        /*
+         * Free slots below tail are linked in a list, where a free slot has
+         * check -1 - next and base -1 - prev, and 0 ends the list
+         */
+
+        std::vector<int> base;
+
+        std::vector<int> check;
+
+        std::vector<T> datas;
+
+        int nodeCnt;
+
+        // slots from tail on are free and not in the list
+        int tail;
+
+        int freeHead;
+
+    public:
+
+        DoubleArrayLayout();
+
+        int son(int p, int c) const
+        {
+            int q = base[p] + c;
+            return base[p] != 0 && q < static_cast<int>(check.size()) && check[q] == p ? q : 0;
+        }
+
+        int add(int p, int c);
+
+        T& data(int p)
+        {
+            return datas[p];
+        }
+
+        const T& data(int p) const
+        {
+            return datas[p];
+        }
+
+        int size() const;
+
+        size_t memory() const;
+
+        void clear();
+    };
+
+    template<class T, char _KEY_L = static_cast<char>(32), char _KEY_R = static_cast<char>(126),
+            template<class, int> class _Layout = DenseLayout>
+    class Trie
+    {
+    public:
+
         static const char KEY_L = _KEY_L;
         static const char KEY_R = _KEY_R;
+        static const int N = _KEY_R - _KEY_L + 1;
         const T DEFAULT_VAL;
 
-        std::vector<Node> nodes;
+        _Layout<T, N> nodes;
 
         Trie();
 
@@ -54,10 +301,16 @@ namespace scc
 
         T& at(const char* key);
 
+        T& at(const char* key, int len);
+
         T& get(const char* key);
 
+        T& get(const char* key, int len);
+
         const T& cfind(const char* key);
 
+        const T& cfind(const char* key, int len);
+
         void clear();
 
         void print(FILE* fp) const;
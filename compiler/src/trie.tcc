@@ -28,30 +28,402 @@
 
 #include <cstdio>
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 namespace scc
 {
-    // class Trie
+    // class DenseLayout
+
+    template<class T, int N>
+    DenseLayout<T, N>::Node::Node() : son{0}, data()
+    {
+    }
+
+    template<class T, int N>
+    DenseLayout<T, N>::DenseLayout()
+    {
+        nodes.emplace_back();
+    }
+
+    template<class T, int N>
+    int DenseLayout<T, N>::add(int p, int c)
+    {
+        if (nodes[p].son[c] == 0)
+        {
+            nodes[p].son[c] = nodes.size();
+            nodes.emplace_back();
+        }
+        return nodes[p].son[c];
+    }
+
+    template<class T, int N>
+    int DenseLayout<T, N>::size() const
+    {
+        return nodes.size();
+    }
+
+    template<class T, int N>
+    size_t DenseLayout<T, N>::memory() const
+    {
+        return nodes.capacity() * sizeof(Node);
+    }
+
+    template<class T, int N>
+    void DenseLayout<T, N>::clear()
+    {
+        nodes.clear();
+        nodes.emplace_back();
+    }
+
+    // class SparseLayout
 
-    template<class T, char KEY_L, char KEY_R>
-    Trie<T, KEY_L, KEY_R>::Node::Node() : son{0}, data()
+    template<class T, int N>
+    SparseLayout<T, N>::Node::Node() : data()
     {
     }
 
-    template<class T, char KEY_L, char KEY_R>
-    Trie<T, KEY_L, KEY_R>::Trie() : DEFAULT_VAL()
+    template<class T, int N>
+    SparseLayout<T, N>::SparseLayout()
     {
         nodes.emplace_back();
+    }
+
+    template<class T, int N>
+    int SparseLayout<T, N>::son(int p, int c) const
+    {
+        const std::vector<std::pair<int, int> >& sons = nodes[p].sons;
+        auto it = std::lower_bound(sons.begin(), sons.end(), std::make_pair(c, 0));
+        return it != sons.end() && it->first == c ? it->second : 0;
+    }
+
+    template<class T, int N>
+    int SparseLayout<T, N>::add(int p, int c)
+    {
+        std::vector<std::pair<int, int> >& sons = nodes[p].sons;
+        auto it = std::lower_bound(sons.begin(), sons.end(), std::make_pair(c, 0));
+        if (it != sons.end() && it->first == c)
+        {
+            return it->second;
+        }
+        int q = nodes.size();
+        sons.emplace(it, c, q);
+        nodes.emplace_back();
+        return q;
+    }
+
+    template<class T, int N>
+    int SparseLayout<T, N>::size() const
+    {
+        return nodes.size();
+    }
+
+    template<class T, int N>
+    size_t SparseLayout<T, N>::memory() const
+    {
+        size_t res = nodes.capacity() * sizeof(Node);
+        for (const Node& node : nodes)
+        {
+            res += node.sons.capacity() * sizeof(std::pair<int, int>);
+        }
+        return res;
+    }
+
+    template<class T, int N>
+    void SparseLayout<T, N>::clear()
+    {
+        nodes.clear();
+        nodes.emplace_back();
+    }
+
+    // class ClassLayout
+
+    template<class T, int N>
+    ClassLayout<T, N>::ClassLayout() : classOf{0}, classCnt(0), width(0)
+    {
+        datas.emplace_back();
+    }
+
+    template<class T, int N>
+    void ClassLayout<T, N>::widen(int width)
+    {
+        int n = datas.size();
+        std::vector<int> buffer(n * width, 0);
+        for (int p = 0; p < n; p++)
+        {
+            std::copy(sons.begin() + p * this->width, sons.begin() + (p + 1) * this->width,
+                    buffer.begin() + p * width);
+        }
+        sons.swap(buffer);
+        this->width = width;
+    }
+
+    template<class T, int N>
+    int ClassLayout<T, N>::add(int p, int c)
+    {
+        if (classOf[c] == 0)
+        {
+            classOf[c] = ++classCnt;
+            if (classCnt > width)
+            {
+                widen(std::min(std::max(width * 2, 8), N));
+            }
+        }
+        int i = p * width + classOf[c] - 1;
+        if (sons[i] == 0)
+        {
+            sons[i] = datas.size();
+            datas.emplace_back();
+            sons.resize(sons.size() + width, 0);
+        }
+        return sons[i];
+    }
+
+    template<class T, int N>
+    int ClassLayout<T, N>::size() const
+    {
+        return datas.size();
+    }
+
+    template<class T, int N>
+    size_t ClassLayout<T, N>::memory() const
+    {
+        return sons.capacity() * sizeof(int) + datas.capacity() * sizeof(T) + sizeof(classOf);
+    }
+
+    template<class T, int N>
+    void ClassLayout<T, N>::clear()
+    {
+        // classes are kept, as the next keys are likely to use the same symbols
+        sons.assign(width, 0);
+        datas.clear();
+        datas.emplace_back();
+    }
+
+    // class DoubleArrayLayout
+
+    template<class T, int N>
+    DoubleArrayLayout<T, N>::DoubleArrayLayout()
+    {
+        clear();
+    }
+
+    template<class T, int N>
+    void DoubleArrayLayout<T, N>::reserve(int n)
+    {
+        if (n > static_cast<int>(check.size()))
+        {
+            n = std::max(n, static_cast<int>(check.size()) * 2);
+            base.resize(n, 0);
+            check.resize(n, -1);
+            datas.resize(n);
+        }
+    }
+
+    template<class T, int N>
+    void DoubleArrayLayout<T, N>::take(int q, int p)
+    {
+        if (q >= tail)
+        {
+            reserve(q + 1);
+            for (int r = tail; r < q; r++)
+            {
+                release(r);
+            }
+            tail = q + 1;
+        }
+        else
+        {
+            int next = -1 - check[q];
+            int prev = -1 - base[q];
+            if (prev != 0)
+            {
+                check[prev] = -1 - next;
+            }
+            else
+            {
+                freeHead = next;
+            }
+            if (next != 0)
+            {
+                base[next] = -1 - prev;
+            }
+        }
+        base[q] = 0;
+        check[q] = p;
+    }
+
+    template<class T, int N>
+    void DoubleArrayLayout<T, N>::release(int q)
+    {
+        datas[q] = T();
+        base[q] = -1;
+        check[q] = -1 - freeHead;
+        if (freeHead != 0)
+        {
+            base[freeHead] = -1 - q;
+        }
+        freeHead = q;
+    }
+
+    template<class T, int N>
+    int DoubleArrayLayout<T, N>::findBase(const int* codes, int n) const
+    {
+        // the first symbol takes a free slot, so only free slots are tried for it,
+        // and only the first few of them, as the list is long in a crowded array
+        int tries = FIND_TRIES;
+        for (int q = freeHead; q != 0 && tries > 0; q = -1 - check[q], tries--)
+        {
+            int b = q - codes[0];
+            if (b < 1)
+            {
+                continue;
+            }
+            int i = 1;
+            while (i < n && isFree(b + codes[i]))
+            {
+                i++;
+            }
+            if (i == n)
+            {
+                return b;
+            }
+        }
+        return std::max(tail - codes[0], 1);
+    }
+
+    template<class T, int N>
+    int DoubleArrayLayout<T, N>::count(int p) const
+    {
+        int res = 0;
+        for (int c = 0; c < N; c++)
+        {
+            if (son(p, c) != 0)
+            {
+                res++;
+            }
+        }
+        return res;
+    }
+
+    template<class T, int N>
+    void DoubleArrayLayout<T, N>::relocate(int p, int c, int& follow)
+    {
+        int codes[N];
+        int n = 0;
+        for (int d = 0; d < N; d++)
+        {
+            if (d == c || son(p, d) != 0)
+            {
+                codes[n++] = d;
+            }
+        }
+        int b = findBase(codes, n);
+        for (int i = 0; i < n; i++)
+        {
+            if (codes[i] == c)
+            {
+                continue;
+            }
+            int from = base[p] + codes[i];
+            int to = b + codes[i];
+            take(to, p);
+            base[to] = base[from];
+            datas[to] = std::move(datas[from]);
+            if (base[from] != 0)
+            {
+                for (int d = 0; d < N && base[from] + d < tail; d++)
+                {
+                    if (check[base[from] + d] == from)
+                    {
+                        check[base[from] + d] = to;
+                    }
+                }
+            }
+            if (follow == from)
+            {
+                follow = to;
+            }
+            release(from);
+        }
+        base[p] = b;
+    }
+
+    template<class T, int N>
+    int DoubleArrayLayout<T, N>::add(int p, int c)
+    {
+        int q = son(p, c);
+        if (q != 0)
+        {
+            return q;
+        }
+        if (base[p] == 0)
+        {
+            base[p] = findBase(&c, 1);
+        }
+        else if (!isFree(base[p] + c))
+        {
+            // move the one of fewer sons, as each son moved costs a scan of its sons,
+            // and p itself may be moved with the sons of the other
+            int other = check[base[p] + c];
+            if (count(other) < count(p) + 1)
+            {
+                relocate(other, -1, p);
+            }
+            else
+            {
+                int none = 0;
+                relocate(p, c, none);
+            }
+        }
+        q = base[p] + c;
+        take(q, p);
+        nodeCnt++;
+        return q;
+    }
+
+    template<class T, int N>
+    int DoubleArrayLayout<T, N>::size() const
+    {
+        return nodeCnt;
+    }
+
+    template<class T, int N>
+    size_t DoubleArrayLayout<T, N>::memory() const
+    {
+        return (base.capacity() + check.capacity()) * sizeof(int) + datas.capacity() * sizeof(T);
+    }
+
+    template<class T, int N>
+    void DoubleArrayLayout<T, N>::clear()
+    {
+        // the root is the only node whose check is itself
+        base.assign(1, 0);
+        check.assign(1, 0);
+        datas.clear();
+        datas.emplace_back();
+        nodeCnt = 1;
+        tail = 1;
+        freeHead = 0;
+    }
+
+    // class Trie
+
+    template<class T, char KEY_L, char KEY_R, template<class, int> class Layout>
+    Trie<T, KEY_L, KEY_R, Layout>::Trie() : DEFAULT_VAL()
+    {
         // TODO
     }
 
-    template<class T, char KEY_L, char KEY_R>
-    Trie<T, KEY_L, KEY_R>::~Trie()
+    template<class T, char KEY_L, char KEY_R, template<class, int> class Layout>
+    Trie<T, KEY_L, KEY_R, Layout>::~Trie()
     {
         // TODO
     }
 
-    template<class T, char KEY_L, char KEY_R>
-    T& Trie<T, KEY_L, KEY_R>::at(const char* key)
+    template<class T, char KEY_L, char KEY_R, template<class, int> class Layout>
+    T& Trie<T, KEY_L, KEY_R, Layout>::at(const char* key)
     {
         int p = 0;
         while (*key != '\0')
@@ -60,31 +432,52 @@ namespace scc
             {
                 throw OutOfRangeError("Trie::at: key out of range");
             }
-            if (nodes[p].son[*key - KEY_L] == 0)
+            p = nodes.add(p, *key - KEY_L);
+            key++;
+        }
+        return nodes.data(p);
+    }
+
+    template<class T, char KEY_L, char KEY_R, template<class, int> class Layout>
+    T& Trie<T, KEY_L, KEY_R, Layout>::at(const char* key, int len)
+    {
+        int p = 0;
+        for (const char* end = key + len; key != end; key++)
+        {
+            if (*key < KEY_L || *key > KEY_R)
             {
-                nodes[p].son[*key - KEY_L] = nodes.size();
-                nodes.emplace_back();
+                throw OutOfRangeError("Trie::at: key out of range");
             }
-            p = nodes[p].son[*key - KEY_L];
-            key++;
+            p = nodes.add(p, *key - KEY_L);
         }
-        return nodes[p].data;
+        return nodes.data(p);
     }
 
-    template<class T, char KEY_L, char KEY_R>
-    T& Trie<T, KEY_L, KEY_R>::get(const char* key)
+    template<class T, char KEY_L, char KEY_R, template<class, int> class Layout>
+    T& Trie<T, KEY_L, KEY_R, Layout>::get(const char* key)
     {
         int p = 0;
         while (*key != '\0')
         {
-            p = nodes[p].son[*key - KEY_L];
+            p = nodes.son(p, *key - KEY_L);
             key++;
         }
-        return nodes[p].data;
+        return nodes.data(p);
+    }
+
+    template<class T, char KEY_L, char KEY_R, template<class, int> class Layout>
+    T& Trie<T, KEY_L, KEY_R, Layout>::get(const char* key, int len)
+    {
+        int p = 0;
+        for (const char* end = key + len; key != end; key++)
+        {
+            p = nodes.son(p, *key - KEY_L);
+        }
+        return nodes.data(p);
     }
 
-    template<class T, char KEY_L, char KEY_R>
-    const T& Trie<T, KEY_L, KEY_R>::cfind(const char* key)
+    template<class T, char KEY_L, char KEY_R, template<class, int> class Layout>
+    const T& Trie<T, KEY_L, KEY_R, Layout>::cfind(const char* key)
     {
         int p = 0;
         while (*key != '\0')
@@ -93,35 +486,63 @@ namespace scc
             {
                 return DEFAULT_VAL;
             }
-            p = nodes[p].son[*key - KEY_L];
+            p = nodes.son(p, *key - KEY_L);
             key++;
             if (p == 0)
             {
                 return DEFAULT_VAL;
             }
         }
-        return nodes[p].data;
+        return nodes.data(p);
     }
 
-    template<class T, char KEY_L, char KEY_R>
-    void Trie<T, KEY_L, KEY_R>::clear()
+    template<class T, char KEY_L, char KEY_R, template<class, int> class Layout>
+    const T& Trie<T, KEY_L, KEY_R, Layout>::cfind(const char* key, int len)
+    {
+        int p = 0;
+        for (const char* end = key + len; key != end; key++)
+        {
+            if (*key < KEY_L || *key > KEY_R)
+            {
+                return DEFAULT_VAL;
+            }
+            p = nodes.son(p, *key - KEY_L);
+            if (p == 0)
+            {
+                return DEFAULT_VAL;
+            }
+        }
+        return nodes.data(p);
+    }
+
+    template<class T, char KEY_L, char KEY_R, template<class, int> class Layout>
+    void Trie<T, KEY_L, KEY_R, Layout>::clear()
     {
         nodes.clear();
-        nodes.emplace_back();
     }
 
-    template<class T, char KEY_L, char KEY_R>
-    void Trie<T, KEY_L, KEY_R>::print(FILE* fp) const
+    template<class T, char KEY_L, char KEY_R, template<class, int> class Layout>
+    void Trie<T, KEY_L, KEY_R, Layout>::print(FILE* fp) const
     {
-        int n = nodes.size();
-        for (int i = 0; i < n; i++)
+        // preorder, as nodes of some layouts are not numbered in a row
+        std::vector<int> stack(1, 0);
+        while (!stack.empty())
         {
-            fprintf(fp, "%d<%d>: ", i, static_cast<int>(nodes[i].data));
-            for (char c = KEY_L; c <= KEY_R; c++)
+            int p = stack.back();
+            stack.pop_back();
+            fprintf(fp, "%d<%d>: ", p, static_cast<int>(nodes.data(p)));
+            for (int c = N - 1; c >= 0; c--)
+            {
+                if (nodes.son(p, c) != 0)
+                {
+                    stack.push_back(nodes.son(p, c));
+                }
+            }
+            for (int c = 0; c < N; c++)
             {
-                if (nodes[i].son[c - KEY_L] != 0)
+                if (nodes.son(p, c) != 0)
                 {
-                    fprintf(fp, "%c:%d ", c, nodes[i].son[c - KEY_L]);
+                    fprintf(fp, "%c:%d ", static_cast<char>(KEY_L + c), nodes.son(p, c));
                 }
             }
             fprintf(fp, "\n");
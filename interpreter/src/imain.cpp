@@ -23,13 +23,28 @@
 #include "interpreter.h"
 #include "../../common/src/exception.h"
 
-void runBin(const char* fileName)
+/**
+ * @param counted: whether to print the count of instructions executed into stderr
+ */
+void runBin(const char* fileName, bool counted)
 {
     sci::BInterpreter interpreter;
 
     interpreter.read(fileName);
 
+    interpreter.setCounted(counted);
+
     interpreter.run();
+
+    if (counted)
+    {
+        fprintf(stderr, "instructions: %lld\n", interpreter.getExecuted());
+    }
+}
+
+void runBin(const char* fileName)
+{
+    runBin(fileName, false);
 }
 
 void runText(const char* fileName)
@@ -47,6 +62,8 @@ int imain(int argc, char** argv)
 
     bool binary = true;
 
+    bool counted = false;
+
     char* fileName = nullptr;
 
     for (int i = 1; i < argc; i++)
@@ -63,6 +80,10 @@ int imain(int argc, char** argv)
         {
             binary = true;
         }
+        else if (argv[i][1] == 'c')
+        {
+            counted = true;
+        }
     }
 
     if (fileName == nullptr)
@@ -75,7 +96,7 @@ int imain(int argc, char** argv)
         {
             if (binary)
             {
-                runBin(fileName); // TODO
+                runBin(fileName, counted); // TODO
             }
             else
             {
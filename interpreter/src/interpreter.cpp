@@ -20,6 +20,7 @@
 
 #include <cstdio>
 #include <cstring>
+#include <climits>
 
 #include "interpreter.h"
 
@@ -28,6 +29,25 @@
 
 namespace sci
 {
+    static bool sandboxed(const BPcode& code)
+    {
+        switch (code.f)
+        {
+        case 0021:
+        case 0031:
+        case 0033:
+        case 0111:
+        case 0121:
+            return false;
+
+        case 0100:
+            return code.a < 14 || code.a > 19;
+
+        default:
+            return true;
+        }
+    }
+
     // class Interpreter
 
     Interpreter::Interpreter() : ip(-1), top(-1), sp(0)
@@ -36,7 +56,7 @@ namespace sci
 
     // class BInterpreter
 
-    BInterpreter::BInterpreter() : codes(nullptr), del(false)
+    BInterpreter::BInterpreter() : codes(nullptr), del(false), counted(false), executed(0)
     {
     }
 
@@ -143,11 +163,19 @@ namespace sci
         del = true;
     }
 
-    void BInterpreter::run()
+    template<bool BOUNDED, bool COUNTED>
+    bool BInterpreter::exec(long long steps)
     {
-        sp = -1;
         while (true)
         {
+            if (BOUNDED && (--steps < 0 || !sandboxed(codes[ip + 1])))
+            {
+                return false;
+            }
+            if (COUNTED)
+            {
+                executed++;
+            }
             switch (codes[++ip].f)
             {
             case 0000:
@@ -257,28 +285,59 @@ namespace sci
                     {
                         continue;
                     }
-                    return;
+                    return true;
 
+                // run inside the compiler when bounded, where overflow must wrap as fold() does
                 case 1:
+                    if (BOUNDED)
+                    {
+                        st[top] = static_cast<int>(0u - static_cast<unsigned>(st[top]));
+                        continue;
+                    }
                     st[top] = -st[top];
                     continue;
 
                 case 2:
+                    if (BOUNDED)
+                    {
+                        st[top - 1] = static_cast<int>(static_cast<unsigned>(st[top - 1])
+                                + static_cast<unsigned>(st[top]));
+                        --top;
+                        continue;
+                    }
                     st[top - 1] += st[top];
                     --top;
                     continue;
 
                 case 3:
+                    if (BOUNDED)
+                    {
+                        st[top - 1] = static_cast<int>(static_cast<unsigned>(st[top - 1])
+                                - static_cast<unsigned>(st[top]));
+                        --top;
+                        continue;
+                    }
                     st[top - 1] -= st[top];
                     --top;
                     continue;
 
                 case 4:
+                    if (BOUNDED)
+                    {
+                        st[top - 1] = static_cast<int>(static_cast<unsigned>(st[top - 1])
+                                * static_cast<unsigned>(st[top]));
+                        --top;
+                        continue;
+                    }
                     st[top - 1] *= st[top];
                     --top;
                     continue;
 
                 case 5:
+                    if (BOUNDED && (st[top] == 0 || (st[top] == -1 && st[top - 1] == INT_MIN)))
+                    {
+                        return false;
+                    }
                     st[top - 1] /= st[top];
                     --top;
                     continue;
@@ -364,6 +423,10 @@ namespace sci
                 };
 
             case 0110:
+                if (BOUNDED && static_cast<unsigned>(sp + codes[ip].a + st[top]) > static_cast<unsigned>(top))
+                {
+                    return false;
+                }
                 st[top] = st[sp + codes[ip].a + st[top]];
                 continue;
 
@@ -372,6 +435,10 @@ namespace sci
                 continue;
 
             case 0120:
+                if (BOUNDED && static_cast<unsigned>(sp + codes[ip].a + st[top - 1]) > static_cast<unsigned>(top))
+                {
+                    return false;
+                }
                 st[sp + codes[ip].a + st[top - 1]] = st[top]; // TODO: Optimize
                 top -= 2;
                 continue;
@@ -385,9 +452,50 @@ namespace sci
                 throw InstructionError("no such instruction", codes[ip].f); // TODO
             }
         }
+    }
+
+    void BInterpreter::run()
+    {
+        sp = -1;
+        if (counted)
+        {
+            exec<false, true>(0);
+        }
+        else
+        {
+            exec<false>(0);
+        }
+    }
 
+    void BInterpreter::setCounted(bool counted)
+    {
+        this->counted = counted;
     }
 
+    long long BInterpreter::getExecuted() const
+    {
+        return executed;
+    }
+
+    bool BInterpreter::call(int addr, const std::vector<int>& params, int& res, long long steps)
+    {
+        // the same as CAL, or CAL reserving a slot for the returned value if no parameter
+        st = params;
+        top = params.size() + (params.empty() ? 2 : 1);
+        st.resize(top + 1);
+        st[top] = -1;
+        st[top - 1] = -1;
+        sp = top - 1;
+        ip = addr - 1;
+        if (!exec<true>(steps))
+        {
+            return false;
+        }
+        res = st[0];
+        return true;
+    }
+
+
     BInterpreter::~BInterpreter()
     {
         if (del)
@@ -60,8 +60,23 @@ namespace sci
 
         bool del;
 
+        // whether run counts the instructions executed into executed
+        bool counted;
+
+        long long executed;
+
         int nextBlock(FILE *fp, BPcodeBlockType type);
 
+        /**
+         * Run codes until the outermost function returns
+         *
+         * @param steps: max count of instructions to execute if BOUNDED,
+         *      in which case instructions touching globals or doing I/O are refused
+         * @return whether the outermost function returned
+         */
+        template<bool BOUNDED, bool COUNTED = false>
+        bool exec(long long steps);
+
     public:
 
         BInterpreter();
@@ -72,6 +87,24 @@ namespace sci
 
         virtual void run() override;
 
+        /**
+         * Count the instructions executed by run, at some cost of speed
+         */
+        void setCounted(bool counted);
+
+        long long getExecuted() const;
+
+        /**
+         * Call a function not touching globals and not doing I/O
+         *
+         * @param addr: address of the function
+         * @param params: values of the parameters
+         * @param res: the returned value
+         * @param steps: max count of instructions to execute
+         * @return whether the function returned in steps
+         */
+        bool call(int addr, const std::vector<int>& params, int& res, long long steps);
+
         virtual ~BInterpreter() override;
     };
 
@@ -0,0 +1,112 @@
+// array-heavy: indexed loads and stores in nested loops
+
+const int N = 1500, PRIME_MAX = 60000, M = 40;
+
+int a[1500];
+int composite[60000];
+int x[1600], y[1600], z[1600];
+
+int seed;
+
+int rand()
+{
+    seed = seed * 1103 + 12345;
+    seed = seed - seed / 65536 * 65536;
+    return (seed);
+}
+
+int digit()
+{
+    int r;
+
+    r = rand();
+    return (r - r / 16 * 16);
+}
+
+void sort()
+{
+    int i, j, t;
+
+    for (i = 0; i < N; i = i + 1)
+    {
+        for (j = 0; j < N - 1 - i; j = j + 1)
+        {
+            if (a[j] > a[j + 1])
+            {
+                t = a[j];
+                a[j] = a[j + 1];
+                a[j + 1] = t;
+            }
+        }
+    }
+}
+
+int sieve()
+{
+    int i, j, cnt;
+
+    cnt = 0;
+    for (i = 2; i < PRIME_MAX; i = i + 1)
+    {
+        if (composite[i] == 0)
+        {
+            cnt = cnt + 1;
+            j = i + i;
+            while (j < PRIME_MAX)
+            {
+                composite[j] = 1;
+                j = j + i;
+            }
+        }
+    }
+    return (cnt);
+}
+
+int multiply()
+{
+    int i, j, k, s, trace;
+
+    for (i = 0; i < M * M; i = i + 1)
+    {
+        x[i] = digit();
+        y[i] = digit();
+    }
+    trace = 0;
+    for (i = 0; i < M; i = i + 1)
+    {
+        for (j = 0; j < M; j = j + 1)
+        {
+            s = 0;
+            for (k = 0; k < M; k = k + 1)
+            {
+                s = s + x[i * M + k] * y[k * M + j];
+            }
+            z[i * M + j] = s;
+        }
+        trace = trace + z[i * M + i];
+    }
+    return (trace);
+}
+
+void main()
+{
+    int i, sorted;
+
+    seed = 1;
+    for (i = 0; i < N; i = i + 1)
+    {
+        a[i] = rand();
+    }
+    sort();
+    sorted = 1;
+    for (i = 1; i < N; i = i + 1)
+    {
+        if (a[i - 1] > a[i])
+        {
+            sorted = 0;
+        }
+    }
+    printf("sorted: ", sorted);
+    printf("primes: ", sieve());
+    printf("trace: ", multiply());
+}
@@ -0,0 +1,26 @@
+// I/O-heavy: a scanf and a printf for each record
+
+void main()
+{
+    int n, i, k, v, sum, max;
+    char c;
+
+    scanf(n);
+    sum = 0;
+    max = 0;
+    for (i = 0; i < n; i = i + 1)
+    {
+        scanf(k, v);
+        sum = sum + v;
+        if (v > max)
+        {
+            max = v;
+        }
+        printf("record ", k);
+        printf(" value ", v);
+        printf(" sum ", sum);
+    }
+    scanf(c);
+    printf("last: ", c);
+    printf("max: ", max);
+}
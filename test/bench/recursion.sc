@@ -0,0 +1,57 @@
+// recursion-heavy: calls, returns and parameters
+
+int fib(int n)
+{
+    if (n < 2)
+    {
+        return (n);
+    }
+    return (fib(n - 1) + fib(n - 2));
+}
+
+int ack(int m, int n)
+{
+    if (m == 0)
+    {
+        return (n + 1);
+    }
+    if (n == 0)
+    {
+        return (ack(m - 1, 1));
+    }
+    return (ack(m - 1, ack(m, n - 1)));
+}
+
+int hanoi(int n, int from, int to, int via)
+{
+    if (n == 0)
+    {
+        return (0);
+    }
+    return (hanoi(n - 1, from, via, to) + 1 + hanoi(n - 1, via, to, from));
+}
+
+int gcd(int a, int b)
+{
+    if (b == 0)
+    {
+        return (a);
+    }
+    return (gcd(b, a - a / b * b));
+}
+
+void main()
+{
+    int i, sum;
+
+    printf("fib: ", fib(27));
+    printf("ack: ", ack(2, 300));
+    printf("hanoi: ", hanoi(18, 1, 3, 2));
+
+    sum = 0;
+    for (i = 1; i <= 20000; i = i + 1)
+    {
+        sum = sum + gcd(i * 7919, 65536 - i);
+    }
+    printf("gcd: ", sum);
+}
@@ -0,0 +1,22 @@
+// zero is never written and scale only once as main begins, so both become constants,
+// acc is used by main alone and becomes its local, while cnt, also written by tick, stays global
+int zero, scale, acc, cnt;
+
+int tick(int x)
+{
+    cnt = cnt + 1;
+    return (x * scale + zero);
+}
+
+void main()
+{
+    int n, i;
+    scale = 3;
+    scanf(n);
+    acc = zero;
+    for (i = 0; i < n; i = i + 1)
+        acc = acc + tick(i);
+    printf(acc);
+    printf(cnt);
+    printf(zero);
+}
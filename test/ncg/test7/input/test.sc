@@ -0,0 +1,76 @@
+const int N = 10;
+int g;
+
+int fact(int n)
+{
+    if (n <= 1)
+        return (1);
+    return (n * fact(n - 1));
+}
+
+int pow2(int e)
+{
+    int r, i;
+    r = 1;
+    for (i = 0; i < e; i = i + 1)
+        r = r * 2;
+    return (r);
+}
+
+int gcd(int a, int b)
+{
+    if (b == 0)
+        return (a);
+    return (gcd(b, a - a / b * b));
+}
+
+int spin(int a)
+{
+    while (a != 0)
+        a = a + 2;
+    return (a);
+}
+
+int next()
+{
+    g = g + 1;
+    return (g);
+}
+
+int cube(int x)
+{
+    return (-(x * x * x));
+}
+
+int seven()
+{
+    return (7);
+}
+
+void main()
+{
+    int n, i, s;
+    scanf(n);
+    printf(fact(N));
+    printf(pow2(16));
+    printf(gcd(84, 36));
+    printf(seven());
+    printf(cube(100000));
+    printf(spin(0));
+    seven();
+    gcd(n, 6);
+    s = 0;
+    i = 0;
+    while (i < n)
+    {
+        if (i == 3)
+            printf("three");
+        else
+            s = s + gcd(i, 6) + next();
+        i = i + 1;
+    }
+    printf(s);
+    if (n > 100)
+        printf(spin(1));
+    printf(fact(n));
+}
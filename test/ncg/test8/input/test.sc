@@ -0,0 +1,66 @@
+// the jump over the inner else jumps to the jump over the outer else
+int classify(int x)
+{
+    int r;
+    if (x > 0)
+    {
+        if (x > 10)
+            r = 2;
+        else
+            r = 1;
+    }
+    else
+        r = 0;
+    return (r);
+}
+
+// the condition jumps over a jump to the end of the else
+int odd(int x)
+{
+    if (x / 2 * 2 == x)
+        ;
+    else
+        return (1);
+    return (0);
+}
+
+// the header of the loop is short enough to be copied to its end
+int sum(int n, int k)
+{
+    int i, s;
+    i = 0;
+    s = 0;
+    while (i * k + 1 < n * 2)
+    {
+        s = s + i;
+        i = i + 1;
+    }
+    return (s);
+}
+
+// the header of the loop is too long to be copied
+int wide(int n, int k)
+{
+    int i, s;
+    i = 0;
+    s = 0;
+    while (i * k + i * 3 + k * 5 + n / 2 - 7 < n * n + k * k + 1)
+    {
+        s = s + 1;
+        i = i + 1;
+    }
+    return (s);
+}
+
+void main()
+{
+    int n;
+    scanf(n);
+    printf(classify(n));
+    printf(classify(n - 20));
+    printf(classify(0 - n));
+    printf(odd(n));
+    printf(odd(n + 1));
+    printf(sum(n, 3));
+    printf(wide(n, 2));
+}
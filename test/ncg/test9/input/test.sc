@@ -0,0 +1,77 @@
+int h;
+
+int id(int x)
+{
+    return (x);
+}
+
+int two(int x, int y)
+{
+    return (x + y);
+}
+
+int echo(int x, int y)
+{
+    printf(x);
+    return (y);
+}
+
+int bump()
+{
+    h = h + 1;
+    return (h);
+}
+
+// add-zero, sub-zero, mul-one, div-one, neg-neg, fold-unary and fold-binary
+int arith(int x)
+{
+    int y;
+    y = x + 0;
+    y = y - 0;
+    y = y * 1;
+    y = y / 1;
+    y = -(-y);
+    y = y + (-3);
+    y = y + 2 * 3;
+    return (y);
+}
+
+// lit-jump, and not-jump as the do-while jumps back on !x before the jump over else
+int cond(int x)
+{
+    int s;
+    s = 0;
+    if (1)
+        s = s + 1;
+    if (x > 2)
+    {
+        do
+            x = x - 1;
+        while (x);
+    }
+    else
+        s = s + 2;
+    return (s + x);
+}
+
+void main()
+{
+    int n, k;
+    scanf(n);
+    // sto-lod and keep-pop, stog-lodg and keepg-pop once each dead call is dropped
+    k = n + 1;
+    id(k);
+    printf(k);
+    h = n;
+    id(h);
+    printf(h);
+    // pop-pop, then lod-pop, lodg-pop and lit-pop
+    id(echo(n, k));
+    two(n, bump());
+    id(n);
+    id(h);
+    id(7);
+    printf(arith(n));
+    printf(cond(n));
+    printf(cond(1));
+}
@@ -0,0 +1,196 @@
+/*
+    Tool for compiling lang file to tables of lexer.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "../../compiler/src/regexp"
+#include "../../compiler/src/dfa"
+#include "../../compiler/src/perfecthash"
+#include "../../common/src/exception.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+#include <string>
+#include <vector>
+
+#define CMD_NAME "lang2dfa: "
+#define ERROR_PREFIX CMD_NAME "error: "
+#define FATAL_ERROR_PREFIX CMD_NAME "fatal error: "
+
+// chars of identifiers scanned by DFALexer, see lexer.cpp
+static const char ID_HEAD[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz";
+static const char ID_TAIL[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz";
+
+/**
+ * Read lang file in the same way as readLang, until END
+ *
+ * @return whether all regexps are valid
+ */
+static bool readLang(FILE* ifp, std::vector<std::string>& typeNames, scc::NFA<int>& nfa)
+{
+    const int BUFFER_MAX = 256;
+    char buffer[BUFFER_MAX];
+    bool valid = true;
+    scc::RegExp<int> regExp(nfa);
+    while (fgets(buffer, BUFFER_MAX, ifp) != nullptr)
+    {
+        char* p = strchr(buffer, ',');
+        if (p == nullptr)
+        {
+            break;
+        }
+        *p = '\0';
+        if (strcmp(buffer, "END") == 0)
+        {
+            return valid;
+        }
+        typeNames.emplace_back(buffer);
+        if (p[1] == '/' && p[2] == '/')
+        {
+            try
+            {
+                regExp.analyze(p + 3, static_cast<int>(typeNames.size()) - 1);
+            }
+            catch (RegExpError& e)
+            {
+                e.setTypeName(typeNames.back().c_str());
+                e.print(stderr);
+                valid = false;
+            }
+        }
+    }
+    fprintf(stderr, FATAL_ERROR_PREFIX "'END' is not found\n");
+    exit(1);
+}
+
+int lang2dfa(int argc, char** argv)
+{
+    FILE *ifp = stdin, *ofp = stdout;
+    if (argc == 3)
+    {
+        ifp = fopen(argv[1], "r");
+        if (ifp == nullptr)
+        {
+            fprintf(stderr, ERROR_PREFIX "%s: %s\n", argv[1], strerror(errno));
+            fprintf(stderr, FATAL_ERROR_PREFIX "Unable to open input file\n");
+            exit(1);
+        }
+        ofp = fopen(argv[2], "w");
+        if (ofp == nullptr)
+        {
+            fprintf(stderr, ERROR_PREFIX "%s: %s\n", argv[2], strerror(errno));
+            fprintf(stderr, FATAL_ERROR_PREFIX "Unable to open output file\n");
+            exit(1);
+        }
+    }
+    else if (argc != 1)
+    {
+        fprintf(stderr, FATAL_ERROR_PREFIX "invalid arguments: 0 or 2 arguments are required\n");
+        exit(1);
+    }
+
+    RuntimeError::setCmdName("lang2dfa");
+    std::vector<std::string> typeNames;
+    scc::NFA<int> nfa;
+    if (!readLang(ifp, typeNames, nfa))
+    {
+        fprintf(stderr, FATAL_ERROR_PREFIX "Invalid lang file\n");
+        exit(1);
+    }
+    scc::DFA<int> dfa;
+    dfa.build(nfa);
+
+    // keywords are the words among identifiers of types other than IDENFR
+    int idType = 0;
+    while (idType < static_cast<int>(typeNames.size()) && typeNames[idType] != "IDENFR")
+    {
+        idType++;
+    }
+    std::vector<std::string> keys;
+    std::vector<int> vals;
+    scc::PerfectHash<int> keywords;
+    if (!dfa.words(ID_HEAD, ID_TAIL, idType, keys, vals) || !keywords.build(keys, vals))
+    {
+        fprintf(stderr, FATAL_ERROR_PREFIX "Unable to hash keywords\n");
+        exit(1);
+    }
+
+    int n = dfa.size();
+    int m = dfa.classCnt;
+
+    fprintf(ofp, "    char typeName[static_cast<unsigned>(TokenType::END)][TYPE_NAME_MAX] =\n    {\n");
+    for (const auto& it : typeNames)
+    {
+        fprintf(ofp, "        \"%s\",\n", it.c_str());
+    }
+    fprintf(ofp, "    };\n\n");
+
+    fprintf(ofp, "    extern constexpr int LANG_CLASS_CNT = %d;\n\n", m);
+    fprintf(ofp, "    extern constexpr int LANG_STATE_CNT = %d;\n\n", n);
+
+    fprintf(ofp, "    extern constexpr unsigned char LANG_CLASS_OF[256] =\n    {");
+    for (int i = 0; i < 256; i++)
+    {
+        fprintf(ofp, i % 16 == 0 ? "\n        %d," : " %d,", dfa.classOf[i]);
+    }
+    fprintf(ofp, "\n    };\n\n");
+
+    fprintf(ofp, "    extern constexpr int LANG_NEXT[%d] =\n    {\n", n * m);
+    for (int s = 0; s < n; s++)
+    {
+        fprintf(ofp, "        // %d\n       ", s);
+        for (int c = 0; c < m; c++)
+        {
+            fprintf(ofp, c != 0 && c % 16 == 0 ? "\n        %d," : " %d,", dfa.next[s * m + c]);
+        }
+        fprintf(ofp, "\n");
+    }
+    fprintf(ofp, "    };\n\n");
+
+    fprintf(ofp, "    extern constexpr TokenType LANG_DATA[%d] =\n    {\n", n);
+    for (int s = 0; s < n; s++)
+    {
+        fprintf(ofp, "        TokenType::%s,\n", typeNames[dfa.data[s]].c_str());
+    }
+    fprintf(ofp, "    };\n\n");
+
+    int k = keywords.size;
+    fprintf(ofp, "    extern constexpr int LANG_KEYWORD_SIZE = %d;\n\n", k);
+    fprintf(ofp, "    extern constexpr unsigned LANG_KEYWORD_MULT = %uu;\n\n", keywords.mult);
+    fprintf(ofp, "    extern constexpr TokenType LANG_KEYWORD_DATA[%d] =\n    {\n", k);
+    for (int i = 0; i < k; i++)
+    {
+        fprintf(ofp, "        TokenType::%s,\n", typeNames[keywords.data[i]].c_str());
+    }
+    fprintf(ofp, "    };\n\n");
+    fprintf(ofp, "    extern constexpr int LANG_KEYWORD_OFFSET[%d] =\n    {", k + 1);
+    for (int i = 0; i <= k; i++)
+    {
+        fprintf(ofp, i % 16 == 0 ? "\n        %d," : " %d,", keywords.offset[i]);
+    }
+    fprintf(ofp, "\n    };\n\n");
+    fprintf(ofp, "    extern constexpr char LANG_KEYWORD_WORDS[] = \"%.*s\";\n", keywords.offset[k],
+            keywords.words);
+
+    fclose(ofp);
+    fclose(ifp);
+    return 0;
+}
@@ -0,0 +1,380 @@
+/*
+    Benchmark of throughput of lexers.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "../../compiler/src/lexer.h"
+#include "../../common/src/exception.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#define CMD_NAME "lexbench: "
+#define ERROR_PREFIX CMD_NAME "error: "
+#define FATAL_ERROR_PREFIX CMD_NAME "fatal error: "
+
+static const char* const USAGE =
+        "usage: lexbench [-i input | -s MB] [-m mix] [-w warmup] [-t trials] [-o output] [-r seed]\n"
+        "  -i input   lex the given source file instead of a generated one\n"
+        "  -s MB      size of the generated source (default 8)\n"
+        "  -m mix     weights of tokens, e.g. ident=30,op=40 (default keyword=10,ident=30,int=10,\n"
+        "             char=2,str=3,op=40,comment=5)\n"
+        "  -w warmup  untimed runs of each lexer (default 2)\n"
+        "  -t trials  timed runs of each lexer (default 10)\n"
+        "  -o output  where the generated source is written (default lexbench.sc)\n"
+        "  -r seed    seed of the generator (default 1)\n";
+
+/**
+ * Lexers to compare, add new lexers here
+ */
+static const struct
+{
+    const char* name;
+    scc::Lexer* (*create)();
+} LEXERS[] =
+{
+    {"TrieLexer", []() -> scc::Lexer* { return new scc::TrieLexer; }},
+    {"DFALexer", []() -> scc::Lexer* { return new scc::DFALexer; }},
+};
+
+// kinds of tokens generated
+
+enum Kind
+{
+    KEYWORD, IDENT, INT, CHAR, STR, OP, COMMENT, KIND_CNT
+};
+
+static const char* const KIND_NAMES[KIND_CNT] = {"keyword", "ident", "int", "char", "str", "op", "comment"};
+
+static const char* const KEYWORDS[] =
+{
+    "const", "int", "char", "void", "main", "if", "else", "do", "while", "for", "scanf", "printf", "return"
+};
+
+static const char* const OPS[] =
+{
+    "+", "-", "*", "/", "<", "<=", ">", ">=", "==", "!=", "=", ";", ",", "(", ")", "[", "]", "{", "}"
+};
+
+static const char ID_HEAD[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz";
+static const char ID_TAIL[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz";
+static const char CHAR_SET[] = "+-*/_0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+
+/**
+ * Parse weights like "ident=30,op=40" into weights, leaving the kinds not given unchanged
+ *
+ * @return false if invalid
+ */
+static bool parseMix(const char* mix, int weights[KIND_CNT])
+{
+    std::string s(mix);
+    size_t p = 0;
+    while (p < s.size())
+    {
+        size_t q = s.find(',', p);
+        if (q == std::string::npos)
+        {
+            q = s.size();
+        }
+        std::string item = s.substr(p, q - p);
+        size_t eq = item.find('=');
+        if (eq == std::string::npos)
+        {
+            return false;
+        }
+        int k = 0;
+        while (k < KIND_CNT && item.compare(0, eq, KIND_NAMES[k]) != 0)
+        {
+            k++;
+        }
+        char* last;
+        long w = strtol(item.c_str() + eq + 1, &last, 10);
+        if (k == KIND_CNT || *last != '\0' || last == item.c_str() + eq + 1 || w < 0)
+        {
+            return false;
+        }
+        weights[k] = static_cast<int>(w);
+        p = q + 1;
+    }
+    return true;
+}
+
+/**
+ * Generate a Sub C source of tokens drawn by weights, which both lexers accept
+ */
+static std::string generate(size_t size, const int weights[KIND_CNT], unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::discrete_distribution<int> kind(weights, weights + KIND_CNT);
+    std::string res;
+    res.reserve(size + 256);
+    int col = 0;
+    while (res.size() < size)
+    {
+        if (col == 0)
+        {
+            res.append(4 * (gen() % 4), ' ');
+        }
+        else
+        {
+            res += ' ';
+        }
+        switch (kind(gen))
+        {
+        case KEYWORD:
+            res += KEYWORDS[gen() % (sizeof(KEYWORDS) / sizeof(*KEYWORDS))];
+            break;
+        case IDENT:
+        {
+            int len = gen() % 12 + 1;
+            res += ID_HEAD[gen() % (sizeof(ID_HEAD) - 1)];
+            for (int i = 1; i < len; i++)
+            {
+                res += ID_TAIL[gen() % (sizeof(ID_TAIL) - 1)];
+            }
+            break;
+        }
+        case INT:
+        {
+            int len = gen() % 9;
+            res += len == 0 ? '0' : static_cast<char>('1' + gen() % 9);
+            for (int i = 1; i < len; i++)
+            {
+                res += static_cast<char>('0' + gen() % 10);
+            }
+            break;
+        }
+        case CHAR:
+            res += '\'';
+            res += CHAR_SET[gen() % (sizeof(CHAR_SET) - 1)];
+            res += '\'';
+            break;
+        case STR:
+        {
+            int len = gen() % 31;
+            res += '"';
+            for (int i = 0; i < len; i++)
+            {
+                // [ !#-~], as in sc.lang
+                char c = static_cast<char>(32 + gen() % 95);
+                res += c == '"' ? ' ' : c;
+            }
+            res += '"';
+            break;
+        }
+        case OP:
+            res += OPS[gen() % (sizeof(OPS) / sizeof(*OPS))];
+            break;
+        case COMMENT:
+        {
+            int len = gen() % 60;
+            res += "//";
+            for (int i = 0; i < len; i++)
+            {
+                res += static_cast<char>(32 + gen() % 95);
+            }
+            col = 12;
+            break;
+        }
+        }
+        if (++col >= 12)
+        {
+            res += '\n';
+            col = 0;
+        }
+    }
+    return res;
+}
+
+static double since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Lex the whole file once
+ *
+ * @param tokenCnt: count of tokens but FEOF
+ * @return checksum of the types and rows of the tokens, which must be the same for all lexers
+ */
+static unsigned long long lex(scc::Lexer& lexer, const char* fileName, long long& tokenCnt)
+{
+    unsigned long long sum = 0;
+    scc::Token token;
+    tokenCnt = 0;
+    lexer.open(fileName);
+    while (true)
+    {
+        token.type = scc::TokenType::NONE;
+        token.val.clear();
+        lexer.nextToken(token);
+        if (token.type == scc::TokenType::FEOF)
+        {
+            break;
+        }
+        sum = sum * 31 + static_cast<unsigned>(token.type) * 65537u + token.row + token.val.size();
+        tokenCnt++;
+    }
+    lexer.close();
+    return sum;
+}
+
+int lexbench(int argc, char** argv)
+{
+    const char* inputFileName = nullptr;
+    const char* outputFileName = "lexbench.sc";
+    double mb = 8;
+    int weights[KIND_CNT] = {10, 30, 10, 2, 3, 40, 5};
+    int warmup = 2, trials = 10;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = i + 1 < argc ? argv[i + 1] : nullptr;
+        bool valid = arg != nullptr && argv[i][0] == '-' && argv[i][1] != '\0' && argv[i][2] == '\0';
+        if (valid)
+        {
+            switch (argv[i][1])
+            {
+            case 'i':
+                inputFileName = arg;
+                break;
+            case 'o':
+                outputFileName = arg;
+                break;
+            case 's':
+                mb = atof(arg);
+                valid = mb > 0;
+                break;
+            case 'm':
+                valid = parseMix(arg, weights);
+                break;
+            case 'w':
+                warmup = atoi(arg);
+                valid = warmup >= 0;
+                break;
+            case 't':
+                trials = atoi(arg);
+                valid = trials > 0;
+                break;
+            case 'r':
+                seed = static_cast<unsigned>(strtoul(arg, nullptr, 10));
+                break;
+            default:
+                valid = false;
+            }
+        }
+        if (!valid)
+        {
+            fprintf(stderr, FATAL_ERROR_PREFIX "invalid arguments\n%s", USAGE);
+            exit(1);
+        }
+        i++;
+    }
+    if (inputFileName == nullptr && std::all_of(weights, weights + KIND_CNT, [](int w) { return w == 0; }))
+    {
+        fprintf(stderr, FATAL_ERROR_PREFIX "invalid arguments: all weights are 0\n");
+        exit(1);
+    }
+
+    RuntimeError::setCmdName("lexbench");
+    scc::loadLang();
+
+    if (inputFileName == nullptr)
+    {
+        std::string source = generate(static_cast<size_t>(mb * (1 << 20)), weights, seed);
+        FILE* fp = fopen(outputFileName, "wb");
+        if (fp == nullptr || fwrite(source.data(), 1, source.size(), fp) != source.size())
+        {
+            fprintf(stderr, ERROR_PREFIX "%s: %s\n", outputFileName, strerror(errno));
+            fprintf(stderr, FATAL_ERROR_PREFIX "Unable to write output file\n");
+            exit(1);
+        }
+        fclose(fp);
+        inputFileName = outputFileName;
+        printf("mix:");
+        for (int k = 0; k < KIND_CNT; k++)
+        {
+            printf(" %s=%d", KIND_NAMES[k], weights[k]);
+        }
+        printf("\n");
+    }
+
+    FILE* fp = fopen(inputFileName, "rb");
+    if (fp == nullptr)
+    {
+        fprintf(stderr, ERROR_PREFIX "%s: %s\n", inputFileName, strerror(errno));
+        fprintf(stderr, FATAL_ERROR_PREFIX "Unable to open input file\n");
+        exit(1);
+    }
+    fseek(fp, 0, SEEK_END);
+    double bytes = ftell(fp);
+    fclose(fp);
+
+    printf("input: %s, %.2f MB, %d warmup + %d trials\n", inputFileName, bytes / (1 << 20), warmup, trials);
+    printf("  %-12s %12s %10s %10s %10s %12s\n", "lexer", "tokens", "best(ms)", "median(ms)", "MB/s", "Mtokens/s");
+    unsigned long long firstSum = 0;
+    for (const auto& it : LEXERS)
+    {
+        scc::Lexer* lexer = it.create();
+        unsigned long long sum = 0;
+        long long tokenCnt = 0;
+        std::vector<double> times;
+        try
+        {
+            for (int i = 0; i < warmup + trials; i++)
+            {
+                auto start = std::chrono::steady_clock::now();
+                sum = lex(*lexer, inputFileName, tokenCnt);
+                if (i >= warmup)
+                {
+                    times.push_back(since(start));
+                }
+            }
+        }
+        catch (const FileError& e)
+        {
+            e.print(stderr);
+            exit(1);
+        }
+        delete lexer;
+
+        std::sort(times.begin(), times.end());
+        double best = times.front(), median = times[times.size() / 2];
+        printf("  %-12s %12lld %10.2f %10.2f %10.1f %12.2f\n", it.name, tokenCnt, best, median,
+                bytes / (1 << 20) / (median / 1000), tokenCnt / 1e6 / (median / 1000));
+
+        if (&it == LEXERS)
+        {
+            firstSum = sum;
+        }
+        else if (sum != firstSum)
+        {
+            fprintf(stderr, FATAL_ERROR_PREFIX "%s disagrees with %s\n", it.name, LEXERS[0].name);
+            exit(1);
+        }
+    }
+    return 0;
+}
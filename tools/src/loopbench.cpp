@@ -0,0 +1,281 @@
+/*
+    Benchmark of compile time of loops.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#define CMD_NAME "loopbench: "
+#define ERROR_PREFIX CMD_NAME "error: "
+#define FATAL_ERROR_PREFIX CMD_NAME "fatal error: "
+
+#ifdef WINDOWS
+#define NULL_DEVICE "NUL"
+#else
+#define NULL_DEVICE "/dev/null"
+#endif
+
+static const char* const USAGE =
+        "usage: loopbench [-c scc] [-n steps] [-d depth] [-t trials] [-o output] [-r seed]\n"
+        "  -c scc     compiler to run (default scc)\n"
+        "  -n steps   count of sources, each twice as large as the last (default 8)\n"
+        "  -d depth   depth of each loop nest (default 4)\n"
+        "  -t trials  timed runs on each source (default 3)\n"
+        "  -o output  prefix of the generated sources (default loopbench)\n"
+        "  -r seed    seed of the generator (default 1)\n";
+
+// shape of a source of scale 1, a source of scale k having k times the variables and loop nests
+
+static const int VAR_CNT = 64;
+static const int NEST_CNT = 8;
+static const int STMT_CNT = 12;
+
+// variables most statements use, so that their stores pile up across loops
+static const int HOT_CNT = 4;
+
+class Generator
+{
+protected:
+
+    std::mt19937 gen;
+
+    std::string res;
+
+    int varCnt;
+
+    int lineCnt;
+
+    std::string var()
+    {
+        return "v" + std::to_string(gen() % 2 == 0 ? gen() % HOT_CNT : gen() % varCnt);
+    }
+
+    void line(int indent, const std::string& s)
+    {
+        res.append(4 * indent, ' ').append(s).push_back('\n');
+        lineCnt++;
+    }
+
+    void stmt(int indent)
+    {
+        std::string target = var(), a = var(), b = var();
+        std::string c = std::to_string(gen() % 9 + 1);
+        if (gen() % 10 < 3)
+        {
+            // a store which may not run, joining those before it
+            line(indent, "if (" + a + " > " + b + ")");
+            line(indent, "{");
+            line(indent + 1, target + " = " + a + " - " + b + ";");
+            line(indent, "}");
+        }
+        else
+        {
+            line(indent, target + " = " + a + " + " + b + " * " + c + ";");
+        }
+    }
+
+    void nest(int indent, int depth)
+    {
+        std::string v = var(), n = std::to_string(gen() % 9 + 1);
+        int kind = gen() % 3;
+        if (kind == 0)
+        {
+            line(indent, "while (" + v + " < " + n + ")");
+        }
+        else if (kind == 1)
+        {
+            line(indent, "for (" + v + " = 0; " + v + " < " + n + "; " + v + " = " + v + " + 1)");
+        }
+        else
+        {
+            line(indent, "do");
+        }
+        line(indent, "{");
+        for (int i = 0; i < STMT_CNT; i++)
+        {
+            if (i == STMT_CNT / 2 && depth > 1)
+            {
+                nest(indent + 1, depth - 1);
+            }
+            stmt(indent + 1);
+        }
+        if (kind != 1)
+        {
+            line(indent + 1, v + " = " + v + " + 1;");
+        }
+        line(indent, "}");
+        if (kind == 2)
+        {
+            line(indent, "while (" + v + " < " + n + ");");
+        }
+    }
+
+public:
+
+    explicit Generator(unsigned seed) : gen(seed), varCnt(0), lineCnt(0)
+    {
+    }
+
+    /**
+     * Generate a function of loop nests over many variables
+     *
+     * @param lineCnt: count of lines generated
+     */
+    std::string generate(int scale, int depth, int& lineCnt)
+    {
+        res.clear();
+        this->lineCnt = 0;
+        varCnt = VAR_CNT * scale;
+        line(0, "int f(int a)");
+        line(0, "{");
+        for (int i = 0; i < varCnt; i += 8)
+        {
+            std::string s = "int v" + std::to_string(i);
+            for (int j = i + 1; j < i + 8 && j < varCnt; j++)
+            {
+                s += ", v" + std::to_string(j);
+            }
+            line(1, s + ";");
+        }
+        for (int i = 0; i < varCnt; i++)
+        {
+            line(1, "v" + std::to_string(i) + " = a;");
+        }
+        for (int i = 0; i < NEST_CNT * scale; i++)
+        {
+            nest(1, depth);
+        }
+        line(1, "return (v0 + v1 + v2 + v3);");
+        line(0, "}");
+        line(0, "void main()");
+        line(0, "{");
+        line(1, "printf(f(1));");
+        line(0, "}");
+        lineCnt = this->lineCnt;
+        return res;
+    }
+};
+
+static double since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int loopbench(int argc, char** argv)
+{
+    const char* scc = "scc";
+    const char* outputPrefix = "loopbench";
+    int steps = 8, depth = 4, trials = 3;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        const char* arg = i + 1 < argc ? argv[i + 1] : nullptr;
+        bool valid = arg != nullptr && argv[i][0] == '-' && argv[i][1] != '\0' && argv[i][2] == '\0';
+        if (valid)
+        {
+            switch (argv[i][1])
+            {
+            case 'c':
+                scc = arg;
+                break;
+            case 'o':
+                outputPrefix = arg;
+                break;
+            case 'n':
+                steps = atoi(arg);
+                valid = steps > 0 && steps <= 16;
+                break;
+            case 'd':
+                depth = atoi(arg);
+                valid = depth > 0;
+                break;
+            case 't':
+                trials = atoi(arg);
+                valid = trials > 0;
+                break;
+            case 'r':
+                seed = static_cast<unsigned>(strtoul(arg, nullptr, 10));
+                break;
+            default:
+                valid = false;
+            }
+        }
+        if (!valid)
+        {
+            fprintf(stderr, FATAL_ERROR_PREFIX "invalid arguments\n%s", USAGE);
+            exit(1);
+        }
+        i++;
+    }
+
+    printf("compiler: %s, depth %d, best of %d trials\n", scc, depth, trials);
+    printf("  %8s %10s %10s %12s %10s\n", "scale", "lines", "best(ms)", "us/line", "exponent");
+    double preLines = 0, preTime = 0;
+    for (int step = 0; step < steps; step++)
+    {
+        int scale = 1 << step, lineCnt;
+        std::string source = Generator(seed).generate(scale, depth, lineCnt);
+        std::string fileName = std::string(outputPrefix) + std::to_string(scale) + ".sc";
+        FILE* fp = fopen(fileName.c_str(), "wb");
+        if (fp == nullptr || fwrite(source.data(), 1, source.size(), fp) != source.size())
+        {
+            fprintf(stderr, ERROR_PREFIX "%s: %s\n", fileName.c_str(), strerror(errno));
+            fprintf(stderr, FATAL_ERROR_PREFIX "Unable to write output file\n");
+            exit(1);
+        }
+        fclose(fp);
+
+        std::string cmd = std::string("\"") + scc + "\" \"" + fileName + "\" -o \"" + outputPrefix + ".bpc\" > "
+                NULL_DEVICE " 2>&1";
+        std::vector<double> times;
+        for (int i = 0; i < trials; i++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            int status = system(cmd.c_str());
+            times.push_back(since(start));
+            if (status != 0)
+            {
+                fprintf(stderr, FATAL_ERROR_PREFIX "%s failed on %s\n", scc, fileName.c_str());
+                exit(1);
+            }
+        }
+
+        // of time against lines since the last source, 1 if linear and 2 if quadratic
+        double best = *std::min_element(times.begin(), times.end());
+        printf("  %8d %10d %10.2f %12.3f", scale, lineCnt, best, best * 1000 / lineCnt);
+        if (step > 0)
+        {
+            printf(" %10.2f", log(best / preTime) / log(lineCnt / preLines));
+        }
+        printf("\n");
+        fflush(stdout);
+        preLines = lineCnt;
+        preTime = best;
+    }
+    return 0;
+}
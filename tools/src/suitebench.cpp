@@ -0,0 +1,540 @@
+/*
+    Benchmark of compiling and running a corpus of programs.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#define CMD_NAME "suitebench: "
+#define ERROR_PREFIX CMD_NAME "error: "
+#define FATAL_ERROR_PREFIX CMD_NAME "fatal error: "
+
+#ifdef WINDOWS
+#define NULL_DEVICE "NUL"
+#else
+#define NULL_DEVICE "/dev/null"
+#endif
+
+static const char* const USAGE =
+        "usage: suitebench [-c scc] [-i sci] [-d dir] [-b baseline] [-l baseline] [-t trials] [-r percent]\n"
+        "                  [-e percent] [-o output] [-u]\n"
+        "  -c scc       compiler to run (default scc)\n"
+        "  -i sci       interpreter to run (default sci)\n"
+        "  -d dir       directory of the corpus, listed in corpus.txt there (default .)\n"
+        "  -b baseline  file of the baseline of pcode size and instructions executed\n"
+        "               (default baseline.txt in the corpus directory)\n"
+        "  -l baseline  file of the baseline of times, local to the machine (default output-baseline.txt)\n"
+        "  -t trials    timed runs of each compile and run, the best kept (default 5)\n"
+        "  -r percent   slowdown allowed beyond the baseline (default 25)\n"
+        "  -e percent   growth of pcode size and instructions executed allowed (default 1)\n"
+        "  -o output    prefix of the generated and compiled files (default suitebench)\n"
+        "  -u           write the results as the baselines instead of checking them\n";
+
+// source or input in corpus.txt written by Generator
+static const char* const GENERATED = "@generated";
+
+// shape of the generated program, a chain of functions of loops over local arrays
+static const int FUN_CNT = 1500;
+static const int LOOP_CNT = 3;
+
+// records of the generated input, each an index and a value
+static const int RECORD_CNT = 8000;
+static const int MAX_VALUE = 65535;
+
+// a slowdown below this is taken as noise, however large relatively
+static const double MIN_SLOWDOWN = 2;
+
+enum Metric
+{
+    COMPILE, SIZE, INSTRUCTIONS, RUN, METRIC_CNT
+};
+
+static const char* const METRIC_NAMES[METRIC_CNT] = {"compile(ms)", "size(bytes)", "instructions", "run(ms)"};
+
+// whether the metric is a time, which varies between runs and machines, or a count, which does not
+static const bool TIMED[METRIC_CNT] = {true, false, false, true};
+
+struct Program
+{
+    std::string name;
+    std::string source;
+    std::string input;
+    double metrics[METRIC_CNT];
+
+    // baseline, found only if >= 0
+    double base[METRIC_CNT];
+};
+
+class Generator
+{
+protected:
+
+    std::mt19937 gen;
+
+    std::string res;
+
+    void line(int indent, const std::string& s)
+    {
+        res.append(4 * indent, ' ').append(s).push_back('\n');
+    }
+
+    std::string num(int n)
+    {
+        return std::to_string(gen() % n + 1);
+    }
+
+    void fun(int k)
+    {
+        line(0, "int f" + std::to_string(k) + "(int p)");
+        line(0, "{");
+        line(1, "int i, s, a[16];");
+        line(1, "s = p;");
+        for (int i = 0; i < LOOP_CNT; i++)
+        {
+            line(1, "for (i = 0; i < 16; i = i + 1)");
+            line(1, "{");
+            line(2, "a[i] = s + i * " + num(9) + ";");
+            line(2, "if (a[i] > " + num(500) + ")");
+            line(2, "{");
+            line(3, "s = s - a[i] / " + num(9) + ";");
+            line(2, "}");
+            line(2, "else");
+            line(2, "{");
+            line(3, "s = s + a[i] - " + num(99) + ";");
+            line(2, "}");
+            line(1, "}");
+        }
+        line(1, "while (s > 1000)");
+        line(1, "{");
+        line(2, "s = s / 2;");
+        line(1, "}");
+        if (k > 0)
+        {
+            line(1, "return (f" + std::to_string(k - 1) + "(s));");
+        }
+        else
+        {
+            line(1, "return (s);");
+        }
+        line(0, "}");
+        line(0, "");
+    }
+
+public:
+
+    explicit Generator(unsigned seed) : gen(seed)
+    {
+    }
+
+    /**
+     * Generate a program of many functions, each run once
+     */
+    std::string generate()
+    {
+        res.clear();
+        for (int k = 0; k < FUN_CNT; k++)
+        {
+            fun(k);
+        }
+        line(0, "void main()");
+        line(0, "{");
+        line(1, "printf(f" + std::to_string(FUN_CNT - 1) + "(1));");
+        line(0, "}");
+        return res;
+    }
+
+    /**
+     * Generate an input of a count, the records and a char, one on each line as scanf of sci reads a line
+     */
+    std::string input()
+    {
+        res = std::to_string(RECORD_CNT) + "\n";
+        for (int k = 0; k < RECORD_CNT; k++)
+        {
+            res.append(std::to_string(k)).push_back('\n');
+            res.append(std::to_string(gen() % (MAX_VALUE + 1))).push_back('\n');
+        }
+        res.append("z\n");
+        return res;
+    }
+};
+
+static double since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @return the best time of trials runs of cmd, exiting if it fails
+ */
+static double timeCommand(const std::string& cmd, int trials)
+{
+    double best = 0;
+    for (int i = 0; i < trials; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        int status = system(cmd.c_str());
+        double time = since(start);
+        if (status != 0)
+        {
+            fprintf(stderr, FATAL_ERROR_PREFIX "failed: %s\n", cmd.c_str());
+            exit(1);
+        }
+        best = i == 0 ? time : std::min(best, time);
+    }
+    return best;
+}
+
+static std::string quote(const std::string& s)
+{
+    return "\"" + s + "\"";
+}
+
+/**
+ * Read the programs listed in corpus.txt, a name, a source and an optional input file on each line,
+ * where empty lines and lines starting with '#' are skipped
+ */
+static std::vector<Program> readCorpus(const std::string& dir)
+{
+    std::string fileName = dir + "/corpus.txt";
+    FILE* fp = fopen(fileName.c_str(), "r");
+    if (fp == nullptr)
+    {
+        fprintf(stderr, ERROR_PREFIX "%s: %s\n", fileName.c_str(), strerror(errno));
+        fprintf(stderr, FATAL_ERROR_PREFIX "Unable to open corpus file\n");
+        exit(1);
+    }
+    std::vector<Program> res;
+    char line[FILENAME_MAX * 3];
+    while (fgets(line, sizeof(line), fp) != nullptr)
+    {
+        char name[FILENAME_MAX], source[FILENAME_MAX], input[FILENAME_MAX];
+        int n = sscanf(line, "%s %s %s", name, source, input);
+        if (n < 1 || name[0] == '#')
+        {
+            continue;
+        }
+        if (n < 2)
+        {
+            fprintf(stderr, FATAL_ERROR_PREFIX "missing source of %s in %s\n", name, fileName.c_str());
+            exit(1);
+        }
+        Program program = Program();
+        program.name = name;
+        program.source = strcmp(source, GENERATED) == 0 ? source : dir + "/" + source;
+        program.input = n < 3 ? NULL_DEVICE : strcmp(input, GENERATED) == 0 ? input : dir + "/" + input;
+        std::fill(program.base, program.base + METRIC_CNT, -1);
+        res.push_back(program);
+    }
+    fclose(fp);
+    return res;
+}
+
+/**
+ * Fill the baselines of programs from the baseline file, if any, a name and the metrics timed or not on
+ * each line
+ */
+static void readBaseline(const std::string& fileName, bool timed, std::vector<Program>& programs)
+{
+    FILE* fp = fopen(fileName.c_str(), "r");
+    if (fp == nullptr)
+    {
+        return;
+    }
+    char line[BUFSIZ];
+    while (fgets(line, sizeof(line), fp) != nullptr)
+    {
+        char name[BUFSIZ];
+        int offset = 0;
+        if (line[0] == '#' || sscanf(line, "%s%n", name, &offset) != 1)
+        {
+            continue;
+        }
+        double base[METRIC_CNT];
+        std::fill(base, base + METRIC_CNT, -1);
+        bool valid = true;
+        for (int i = 0; i < METRIC_CNT && valid; i++)
+        {
+            int n = 0;
+            valid = TIMED[i] != timed || sscanf(line + offset, "%lf%n", base + i, &n) == 1;
+            offset += n;
+        }
+        for (auto& it : programs)
+        {
+            if (valid && it.name == name)
+            {
+                for (int i = 0; i < METRIC_CNT; i++)
+                {
+                    if (TIMED[i] == timed)
+                    {
+                        it.base[i] = base[i];
+                    }
+                }
+            }
+        }
+    }
+    fclose(fp);
+}
+
+static void writeBaseline(const std::string& fileName, bool timed, const std::vector<Program>& programs)
+{
+    FILE* fp = fopen(fileName.c_str(), "w");
+    if (fp == nullptr)
+    {
+        fprintf(stderr, ERROR_PREFIX "%s: %s\n", fileName.c_str(), strerror(errno));
+        fprintf(stderr, FATAL_ERROR_PREFIX "Unable to write baseline file\n");
+        exit(1);
+    }
+    fprintf(fp, "# baseline of make bench%s, written by 'make bench args=-u'\n# name",
+            timed ? " on this machine" : "");
+    for (int i = 0; i < METRIC_CNT; i++)
+    {
+        if (TIMED[i] == timed)
+        {
+            fprintf(fp, " %s", METRIC_NAMES[i]);
+        }
+    }
+    fprintf(fp, "\n");
+    for (const auto& it : programs)
+    {
+        fprintf(fp, "%s", it.name.c_str());
+        for (int i = 0; i < METRIC_CNT; i++)
+        {
+            if (TIMED[i] == timed)
+            {
+                fprintf(fp, TIMED[i] ? " %.3f" : " %.0f", it.metrics[i]);
+            }
+        }
+        fprintf(fp, "\n");
+    }
+    fclose(fp);
+}
+
+/**
+ * Write the file generated for a program
+ */
+static void writeGenerated(const std::string& fileName, const std::string& content)
+{
+    FILE* fp = fopen(fileName.c_str(), "wb");
+    if (fp == nullptr || fwrite(content.data(), 1, content.size(), fp) != content.size())
+    {
+        fprintf(stderr, ERROR_PREFIX "%s: %s\n", fileName.c_str(), strerror(errno));
+        fprintf(stderr, FATAL_ERROR_PREFIX "Unable to write output file\n");
+        exit(1);
+    }
+    fclose(fp);
+}
+
+/**
+ * Compile and run the program, filling its metrics
+ */
+static void measure(Program& program, const char* scc, const char* sci, const std::string& outputPrefix,
+        int trials)
+{
+    std::string object = outputPrefix + "-" + program.name + ".bpc";
+    std::string stats = outputPrefix + "-" + program.name + ".txt";
+
+    std::string cmd = quote(scc) + " " + quote(program.source) + " -o " + quote(object)
+            + " > " NULL_DEVICE " 2>&1";
+    program.metrics[COMPILE] = timeCommand(cmd, trials);
+
+    FILE* fp = fopen(object.c_str(), "rb");
+    if (fp == nullptr)
+    {
+        fprintf(stderr, FATAL_ERROR_PREFIX "no object of %s\n", program.name.c_str());
+        exit(1);
+    }
+    fseek(fp, 0, SEEK_END);
+    program.metrics[SIZE] = ftell(fp);
+    fclose(fp);
+
+    // counted once, as counting slows the interpreter down
+    cmd = quote(sci) + " -c " + quote(object) + " < " + quote(program.input) + " > " NULL_DEVICE " 2> "
+            + quote(stats);
+    timeCommand(cmd, 1);
+    long long instructions = -1;
+    fp = fopen(stats.c_str(), "r");
+    if (fp == nullptr || fscanf(fp, "instructions: %lld", &instructions) != 1)
+    {
+        fprintf(stderr, FATAL_ERROR_PREFIX "no count of instructions of %s in %s\n", program.name.c_str(),
+                stats.c_str());
+        exit(1);
+    }
+    fclose(fp);
+    program.metrics[INSTRUCTIONS] = instructions;
+
+    cmd = quote(sci) + " " + quote(object) + " < " + quote(program.input) + " > " NULL_DEVICE;
+    program.metrics[RUN] = timeCommand(cmd, trials);
+}
+
+int suitebench(int argc, char** argv)
+{
+    const char* scc = "scc";
+    const char* sci = "sci";
+    const char* dir = ".";
+    const char* baselineFileName = nullptr;
+    const char* localFileName = nullptr;
+    const char* outputPrefix = "suitebench";
+    int trials = 5;
+    double slowdown = 25, growth = 1;
+    bool update = false;
+    for (int i = 1; i < argc; i++)
+    {
+        bool valid = argv[i][0] == '-' && argv[i][1] != '\0' && argv[i][2] == '\0';
+        if (valid && argv[i][1] == 'u')
+        {
+            update = true;
+            continue;
+        }
+        const char* arg = i + 1 < argc ? argv[i + 1] : nullptr;
+        valid = valid && arg != nullptr;
+        if (valid)
+        {
+            switch (argv[i][1])
+            {
+            case 'c':
+                scc = arg;
+                break;
+            case 'i':
+                sci = arg;
+                break;
+            case 'd':
+                dir = arg;
+                break;
+            case 'b':
+                baselineFileName = arg;
+                break;
+            case 'l':
+                localFileName = arg;
+                break;
+            case 'o':
+                outputPrefix = arg;
+                break;
+            case 't':
+                trials = atoi(arg);
+                valid = trials > 0;
+                break;
+            case 'r':
+                slowdown = atof(arg);
+                valid = slowdown >= 0;
+                break;
+            case 'e':
+                growth = atof(arg);
+                valid = growth >= 0;
+                break;
+            default:
+                valid = false;
+            }
+        }
+        if (!valid)
+        {
+            fprintf(stderr, FATAL_ERROR_PREFIX "invalid arguments\n%s", USAGE);
+            exit(1);
+        }
+        i++;
+    }
+    std::string baseline = baselineFileName != nullptr ? baselineFileName : std::string(dir) + "/baseline.txt";
+    std::string local = localFileName != nullptr ? localFileName : std::string(outputPrefix) + "-baseline.txt";
+
+    // counts are the same on any machine, so their baseline is shared, while times are only comparable
+    // to those measured on the same machine
+    std::vector<Program> programs = readCorpus(dir);
+    readBaseline(baseline, false, programs);
+    readBaseline(local, true, programs);
+
+    printf("compiler: %s, interpreter: %s, best of %d trials\n", scc, sci, trials);
+    printf("  %-12s", "program");
+    for (int i = 0; i < METRIC_CNT; i++)
+    {
+        printf(" %22s", METRIC_NAMES[i]);
+    }
+    printf("\n");
+
+    int regressions = 0, missing = 0;
+    for (auto& it : programs)
+    {
+        if (it.source == GENERATED)
+        {
+            it.source = std::string(outputPrefix) + "-" + it.name + ".sc";
+            writeGenerated(it.source, Generator(1).generate());
+        }
+        if (it.input == GENERATED)
+        {
+            it.input = std::string(outputPrefix) + "-" + it.name + ".in";
+            writeGenerated(it.input, Generator(1).input());
+        }
+        measure(it, scc, sci, outputPrefix, trials);
+
+        // each metric with its change from the baseline, marked with '!' if it regresses
+        printf("  %-12s", it.name.c_str());
+        for (int i = 0; i < METRIC_CNT; i++)
+        {
+            char buffer[64];
+            if (TIMED[i])
+            {
+                snprintf(buffer, sizeof(buffer), "%.2f", it.metrics[i]);
+            }
+            else
+            {
+                snprintf(buffer, sizeof(buffer), "%.0f", it.metrics[i]);
+            }
+            if (it.base[i] < 0)
+            {
+                printf(" %22s", buffer);
+                missing++;
+                continue;
+            }
+            double change = it.base[i] > 0 ? 100 * (it.metrics[i] / it.base[i] - 1) : 0;
+            bool regressed = TIMED[i] ? change > slowdown && it.metrics[i] - it.base[i] > MIN_SLOWDOWN
+                    : change > growth;
+            regressions += regressed;
+            printf(" %12s (%+6.1f%%)%c", buffer, change, regressed ? '!' : ' ');
+        }
+        printf("\n");
+        fflush(stdout);
+    }
+
+    if (update)
+    {
+        writeBaseline(baseline, false, programs);
+        writeBaseline(local, true, programs);
+        printf("baselines written to %s and %s\n", baseline.c_str(), local.c_str());
+        return 0;
+    }
+    if (missing > 0)
+    {
+        printf("%d metric(s) without a baseline, times written to %s by -u\n", missing, local.c_str());
+    }
+    if (regressions > 0)
+    {
+        printf("%d regression(s) beyond the baselines in %s and %s\n", regressions, baseline.c_str(),
+                local.c_str());
+        return 1;
+    }
+    printf("no regression beyond the baselines\n");
+    return 0;
+}
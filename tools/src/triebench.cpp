@@ -0,0 +1,171 @@
+/*
+    Benchmark of node layouts of trie.
+    Copyright (C) 2020-2021 Renjian Wang
+
+    This file is part of SCC.
+
+    SCC is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    SCC is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with SCC.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "../../compiler/src/trie"
+#include "../../common/src/exception.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#define CMD_NAME "triebench: "
+#define FATAL_ERROR_PREFIX CMD_NAME "fatal error: "
+
+static const char ID_HEAD[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz";
+static const char ID_TAIL[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz";
+
+static std::vector<std::string> identifiers(int n, int maxLen, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::vector<std::string> res(n);
+    for (auto& it : res)
+    {
+        int len = gen() % maxLen + 1;
+        it += ID_HEAD[gen() % (sizeof(ID_HEAD) - 1)];
+        while (static_cast<int>(it.size()) < len)
+        {
+            it += ID_TAIL[gen() % (sizeof(ID_TAIL) - 1)];
+        }
+    }
+    return res;
+}
+
+static std::vector<std::string> strings(int n, int maxLen, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::vector<std::string> res(n);
+    for (auto& it : res)
+    {
+        int len = gen() % maxLen + 1;
+        while (static_cast<int>(it.size()) < len)
+        {
+            // printable but '"' and '\\', as in string literals
+            char c = static_cast<char>(32 + gen() % 95);
+            it += c == '"' || c == '\\' ? ' ' : c;
+        }
+    }
+    return res;
+}
+
+static double since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Insert keys, then look up keys and misses rounds times, and print a line of the table
+ *
+ * @param scope: keys per scope if positive, the trie is cleared after each scope as localTrie
+ * @return checksum of the lookups, which must be the same for all layouts
+ */
+template<class Trie>
+static long long run(const char* name, const std::vector<std::string>& keys,
+        const std::vector<std::string>& misses, int rounds, int scope)
+{
+    Trie* trie = new Trie;
+    long long sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    int n = keys.size();
+    for (int i = 0; i < n; i++)
+    {
+        if (scope > 0 && i % scope == 0)
+        {
+            trie->clear();
+        }
+        int& id = trie->at(keys[i].data(), keys[i].size());
+        if (id == 0)
+        {
+            id = i + 1;
+        }
+    }
+    double insertTime = since(start);
+    size_t memory = trie->nodes.memory();
+    int nodeCnt = trie->nodes.size();
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++)
+    {
+        for (int i = scope > 0 ? (n - 1) / scope * scope : 0; i < n; i++)
+        {
+            sum += trie->cfind(keys[i].data(), keys[i].size());
+        }
+        for (const auto& it : misses)
+        {
+            sum += trie->cfind(it.data(), it.size());
+        }
+    }
+    double findTime = since(start);
+
+    printf("  %-12s %10.2f %10.2f %12zu %10d\n", name, insertTime, findTime, memory, nodeCnt);
+    delete trie;
+    return sum;
+}
+
+template<class T, char KEY_L, char KEY_R>
+static void compare(const char* title, const std::vector<std::string>& keys,
+        const std::vector<std::string>& misses, int rounds, int scope = 0)
+{
+    printf("%s\n  %-12s %10s %10s %12s %10s\n", title, "layout", "insert(ms)", "find(ms)", "memory(B)", "nodes");
+    long long sums[] =
+    {
+        run<scc::Trie<T, KEY_L, KEY_R, scc::DenseLayout> >("dense", keys, misses, rounds, scope),
+        run<scc::Trie<T, KEY_L, KEY_R, scc::SparseLayout> >("sparse", keys, misses, rounds, scope),
+        run<scc::Trie<T, KEY_L, KEY_R, scc::ClassLayout> >("class", keys, misses, rounds, scope),
+        run<scc::Trie<T, KEY_L, KEY_R, scc::DoubleArrayLayout> >("double-array", keys, misses, rounds, scope),
+    };
+    for (long long it : sums)
+    {
+        if (it != sums[0])
+        {
+            fprintf(stderr, FATAL_ERROR_PREFIX "layouts disagree on %s\n", title);
+            exit(1);
+        }
+    }
+    printf("\n");
+}
+
+int triebench(int argc, char** argv)
+{
+    int scale = 1;
+    if (argc == 2)
+    {
+        scale = atoi(argv[1]);
+    }
+    if (argc > 2 || scale <= 0)
+    {
+        fprintf(stderr, FATAL_ERROR_PREFIX "invalid arguments: an optional positive scale is required\n");
+        exit(1);
+    }
+
+    RuntimeError::setCmdName("triebench");
+    compare<int, '0', 'z'>("identifiers (globalTrie, funTrie)", identifiers(20000 * scale, 12, 1),
+            identifiers(20000 * scale, 12, 2), 20);
+    compare<int, '0', 'z'>("long identifiers", identifiers(5000 * scale, 64, 3),
+            identifiers(5000 * scale, 64, 4), 20);
+    compare<int, '0', 'z'>("scopes of 40 (localTrie)", identifiers(200000 * scale, 8, 5),
+            identifiers(40, 8, 6), 20000, 40);
+    compare<int, ' ', '~'>("string literals (strTrie)", strings(5000 * scale, 40, 7),
+            strings(5000 * scale, 40, 8), 20);
+    return 0;
+}